@@ -4,34 +4,39 @@
 
 using namespace std;
 using namespace algo;
+// Policy: 插桩策略，默认 NoOpPolicy 不产生任何额外代码
+template<typename Policy = NoOpPolicy>
 int Partition1(vector<int> & R, int s, int t) {
     int i = s, j = t;
     int base = R[s];
 
     while (i < j) {
         // 从右向左找小于基准的元素
-        while (i < j && R[j] >= base) {
+        while (i < j && Policy::compare(R[j] >= base)) {
             j--;
         }
         if (i < j) {
             // j占了i的位置，i往后走，j原本位置变为base (坑)
             R[i] = R[j];
+            Policy::move();
             i++;
         }
 
         // 从左向右找大于基准的元素
-        while (i < j && R[i] <= base) {
+        while (i < j && Policy::compare(R[i] <= base)) {
             i++;
         }
         if (i < j) {
             // i占了j的位置，j往前走，i原本位置变为base (坑)
             R[j] = R[i];
+            Policy::move();
             j--;
         }
     }
 
     // 基准归位 (填坑)
     R[i] = base;
+    Policy::move();
     return i;
 }
 
@@ -51,9 +56,11 @@ int main() {
     AlgorithmTester tester("Partition1");
     int pivot_index = 0;
 
-    tester.testPerformance([&]() {
-        pivot_index = Partition1(arr, low, high);
-    }, arr.size());
+    auto timed = array_utils::copy(arr);
+    tester.testPerformanceCounted(
+        [&]() { Partition1(timed, low, high); },
+        [&]() { pivot_index = Partition1<CountingPolicy>(arr, low, high); },
+        arr.size());
 
     cout << "\n📍 基准位置: " << pivot_index << endl;
     cout << "📍 基准值: " << arr[pivot_index] << endl;
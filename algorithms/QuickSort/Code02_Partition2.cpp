@@ -5,21 +5,25 @@
 using namespace std;
 using namespace algo;
 
+// Policy: 插桩策略，默认 NoOpPolicy 不产生任何额外代码
+template<typename Policy = NoOpPolicy>
 int Partition2(vector<int> & R, int s, int t) {
     int i = s, j = s + 1;
     int base = R[s];
 
     // j遍历数组，维护i为小于等于base的区域末尾
     while (j <= t) {
-        if (R[j] <= base) {
+        if (Policy::compare(R[j] <= base)) {
             i++;
             swap(R[i], R[j]);
+            Policy::swap();
         }
         j++;
     }
 
     // 将基准元素放到正确位置
     swap(R[s], R[i]);
+    Policy::swap();
     return i;
 }
 
@@ -39,9 +43,11 @@ int main() {
     AlgorithmTester tester("Partition2");
     int pivot_index = 0;
 
-    tester.testPerformance([&]() {
-        pivot_index = Partition2(arr, low, high);
-    }, arr.size());
+    auto timed = array_utils::copy(arr);
+    tester.testPerformanceCounted(
+        [&]() { Partition2(timed, low, high); },
+        [&]() { pivot_index = Partition2<CountingPolicy>(arr, low, high); },
+        arr.size());
 
     cout << "\n📍 基准位置: " << pivot_index << endl;
     cout << "📍 基准值: " << arr[pivot_index] << endl;
@@ -5,28 +5,45 @@
 using namespace std;
 using namespace algo;
 
+template<typename Policy = NoOpPolicy>
 int Partition2(vector<int> & R, int s, int t) {
     int i = s, j = s + 1;
     int base = R[s];
 
     while (j <= t) {
-        if (R[j] <= base) {
+        if (Policy::compare(R[j] <= base)) {
             i++;
             swap(R[i], R[j]);
+            Policy::swap();
         }
         j++;
     }
 
     swap(R[s], R[i]);
+    Policy::swap();
     return i;
 }
 
+// Policy: 插桩策略，默认 NoOpPolicy 不产生任何额外代码；CountingPolicy 统计操作次数
+template<typename Policy = NoOpPolicy>
 void QuickSort(vector<int> & R, int s, int t) {
+    Policy::enter();
     if (s < t) {
-        int pivot = Partition2(R, s, t);  // 分割
-        QuickSort(R, s, pivot - 1);       // 递归排序左半部分
-        QuickSort(R, pivot + 1, t);       // 递归排序右半部分
+        int pivot = Partition2<Policy>(R, s, t);  // 分割
+        QuickSort<Policy>(R, s, pivot - 1);       // 递归排序左半部分
+        QuickSort<Policy>(R, pivot + 1, t);       // 递归排序右半部分
     }
+    Policy::leave();
+}
+
+// 用计数策略再排一遍，输出操作次数（计时用的那次不插桩）
+void printCounts(vector<int> & data) {
+    CountingPolicy::reset();
+    QuickSort<CountingPolicy>(data, 0, data.size() - 1);
+
+    const OpStats & stats = CountingPolicy::stats();
+    cout << "   比较 " << stats.comparisons << " 次, 交换 " << stats.swaps
+         << " 次, 递归深度 " << stats.max_depth << " 层" << endl;
 }
 
 int main() {
@@ -41,11 +58,13 @@ int main() {
     // 性能测试
     {
         auto data_copy = array_utils::copy(test_data);
+        auto timed = array_utils::copy(test_data);
         AlgorithmTester tester("快速排序");
 
-        tester.testPerformance([&]() {
-            QuickSort(data_copy, 0, data_copy.size() - 1);
-        }, test_data.size());
+        tester.testPerformanceCounted(
+            [&]() { QuickSort(timed, 0, timed.size() - 1); },
+            [&]() { QuickSort<CountingPolicy>(data_copy, 0, data_copy.size() - 1); },
+            test_data.size());
 
         cout << "📊 排序结果: ";
         array_utils::print(data_copy, "", 20);
@@ -85,25 +104,31 @@ int main() {
         // 1. 随机数据
         {
             auto data = array_utils::generateRandom(test_size);
+            auto counted = array_utils::copy(data);
             Timer timer("随机数据");
             QuickSort(data, 0, data.size() - 1);
             timer.stop();
+            printCounts(counted);
         }
 
         // 2. 已排序数据（最坏情况）
         {
             auto data = array_utils::generateSorted(test_size);
+            auto counted = array_utils::copy(data);
             Timer timer("已排序数据（最坏情况）");
             QuickSort(data, 0, data.size() - 1);
             timer.stop();
+            printCounts(counted);
         }
 
         // 3. 逆序数据
         {
             auto data = array_utils::generateReverse(test_size);
+            auto counted = array_utils::copy(data);
             Timer timer("逆序数据");
             QuickSort(data, 0, data.size() - 1);
             timer.stop();
+            printCounts(counted);
         }
     }
 
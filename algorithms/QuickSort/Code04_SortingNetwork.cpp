@@ -0,0 +1,239 @@
+#include "utility.h"
+#include "sorting_network.h"
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace algo;
+using namespace algo::sorting_network;
+
+int Partition2(vector<int> & R, int s, int t) {
+    int i = s, j = s + 1;
+    int base = R[s];
+
+    while (j <= t) {
+        if (R[j] <= base) {
+            i++;
+            swap(R[i], R[j]);
+        }
+        j++;
+    }
+
+    swap(R[s], R[i]);
+    return i;
+}
+
+// 对照组：纯递归快速排序（同 Code03）
+void QuickSort(vector<int> & R, int s, int t) {
+    if (s < t) {
+        int pivot = Partition2(R, s, t);
+        QuickSort(R, s, pivot - 1);
+        QuickSort(R, pivot + 1, t);
+    }
+}
+
+// 对照组：小数组用的插入排序
+void InsertionSort(int * a, int n) {
+    for (int i = 1; i < n; i++) {
+        int key = a[i];
+        int j = i - 1;
+        while (j >= 0 && a[j] > key) {
+            a[j + 1] = a[j];
+            j--;
+        }
+        a[j + 1] = key;
+    }
+}
+
+// 叶子用插入排序的快速排序
+void QuickSortInsertion(vector<int> & R, int s, int t) {
+    int n = t - s + 1;
+    if (n <= static_cast<int>(kMaxSize)) {
+        if (n > 1) InsertionSort(R.data() + s, n);
+        return;
+    }
+    int pivot = Partition2(R, s, t);
+    QuickSortInsertion(R, s, pivot - 1);
+    QuickSortInsertion(R, pivot + 1, t);
+}
+
+// 叶子用排序网络的快速排序
+void QuickSortNetwork(vector<int> & R, int s, int t) {
+    int n = t - s + 1;
+    if (n <= static_cast<int>(kMaxSize)) {
+        if (n > 1) sortSmall(R.data() + s, n);
+        return;
+    }
+    int pivot = Partition2(R, s, t);
+    QuickSortNetwork(R, s, pivot - 1);
+    QuickSortNetwork(R, pivot + 1, t);
+}
+
+/**
+ * @brief 对一批长度为 n 的小数组计时，返回每个数组的平均纳秒数
+ *
+ * pool 里连续存放 count 个小数组；每轮先整体拷贝再排序，取多轮最小值。
+ */
+template<typename SortFunc>
+double benchSmall(const vector<int>& pool, int n, int count, SortFunc sort_func) {
+    vector<int> work(pool.size());
+    double best = 1e300;
+
+    for (int round = 0; round < 5; round++) {
+        copy(pool.begin(), pool.end(), work.begin());
+
+        auto start = chrono::high_resolution_clock::now();
+        for (int k = 0; k < count; k++) {
+            sort_func(work.data() + k * n, n);
+        }
+        auto end = chrono::high_resolution_clock::now();
+
+        double ns = chrono::duration<double, nano>(end - start).count() / count;
+        best = min(best, ns);
+    }
+
+    // 顺便验证结果，防止编译器把排序优化掉
+    for (int k = 0; k < count; k++) {
+        if (!is_sorted(work.begin() + k * n, work.begin() + (k + 1) * n)) {
+            return -1;
+        }
+    }
+    return best;
+}
+
+int main() {
+    printAlgorithmTitle("快速排序 + 排序网络叶子");
+
+    // 测试数据
+    vector<int> test_data = {5, 3, 1, 9, 2, 8, 4, 7, 6, 10};
+
+    cout << "📊 原始数组: ";
+    array_utils::print(test_data, "", 20);
+
+    {
+        auto data_copy = array_utils::copy(test_data);
+        sortSmall(data_copy.data(), data_copy.size());
+
+        cout << "📊 10 路排序网络结果（" << kNetwork<10>.size << " 个比较器）: ";
+        array_utils::print(data_copy, "", 20);
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 0-1 原理：能排好所有 0/1 序列的网络就能排好任意序列
+    {
+        cout << "🔍 排序网络验证（n <= 16 穷举 0/1 序列，其余随机）:" << endl;
+        bool all_ok = true;
+        mt19937 gen(2024);
+
+        for (int n = 2; n <= static_cast<int>(kMaxSize); n++) {
+            vector<int> a(n);
+            bool ok = true;
+            if (n <= 16) {
+                for (unsigned mask = 0; mask < (1u << n) && ok; mask++) {
+                    for (int i = 0; i < n; i++) a[i] = (mask >> i) & 1;
+                    sortSmall(a.data(), n);
+                    ok = is_sorted(a.begin(), a.end());
+                }
+            } else {
+                for (int iter = 0; iter < 100000 && ok; iter++) {
+                    for (int i = 0; i < n; i++) a[i] = gen() % 4;
+                    sortSmall(a.data(), n);
+                    ok = is_sorted(a.begin(), a.end());
+                }
+            }
+            all_ok = all_ok && ok;
+        }
+        cout << "   结果: " << (all_ok ? "✅ 正确" : "❌ 错误") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 小数组：排序网络 vs 插入排序
+    {
+        cout << "💪 小数组性能（每个数组平均耗时）:" << endl;
+        cout << "   " << alignRight("n", 4) << alignRight("比较器", 10)
+             << alignRight("插入排序", 14) << alignRight("排序网络", 14) << alignRight("加速比", 10) << endl;
+
+        for (int n = 2; n <= static_cast<int>(kMaxSize); n++) {
+            int count = 200000 / n + 1000;
+            auto pool = array_utils::generateRandom(static_cast<size_t>(count) * n, 1, 1000000);
+
+            double t_ins = benchSmall(pool, n, count, InsertionSort);
+            double t_net = benchSmall(pool, n, count, [](int * a, int len) {
+                sortSmall(a, len);
+            });
+
+            cout << "   " << setw(4) << n << setw(10) << comparatorCount(n)
+                 << fixed << setprecision(1)
+                 << setw(11) << t_ins << " ns" << setw(11) << t_net << " ns"
+                 << setw(9) << (t_ins / t_net) << "x" << endl;
+        }
+        cout.unsetf(ios::fixed);
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 整体排序：不同叶子策略
+    {
+        cout << "📈 不同叶子策略的快速排序:" << endl;
+        vector<size_t> sizes = {10000, 100000, 1000000};
+
+        for (size_t size : sizes) {
+            auto random_data = array_utils::generateRandom(size, 1, 1000000000);
+            auto a = array_utils::copy(random_data);
+            auto b = array_utils::copy(random_data);
+            auto c = array_utils::copy(random_data);
+
+            cout << "\n   规模: " << size << endl;
+            AlgorithmTester tester("快速排序");
+            tester.compareAlgorithms(
+                {"纯递归", "插入排序叶子", "排序网络叶子"},
+                [&]() { QuickSort(a, 0, a.size() - 1); },
+                [&]() { QuickSortInsertion(b, 0, b.size() - 1); },
+                [&]() { QuickSortNetwork(c, 0, c.size() - 1); });
+
+            bool valid = array_utils::isSorted(a) && array_utils::isSorted(b) && array_utils::isSorted(c);
+            cout << "   验证: " << (valid ? "✅" : "❌") << endl;
+        }
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 算法特性:" << endl;
+    cout << "   • 排序网络: 比较器序列固定，与数据无关" << endl;
+    cout << "   • 2~9、16 路: 已知最优网络；10~15 路: 裁剪 16 路网络；17~32 路: Batcher 奇偶归并" << endl;
+    cout << "   • 比较交换用 min/max 实现，没有分支预测失败" << endl;
+    cout << "   • 网络在编译期生成并完全展开，下标都是常量" << endl;
+    cout << "   • 适用场景: 快速排序递归到 32 个元素以内时的叶子" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - 排序网络叶子
+ *
+ * 快速排序在随机数据上，大半时间其实耗在一堆很小的子数组上 (⊙_⊙)
+ * 这时候 Partition2 里那个 if 几乎每次都猜错，CPU 流水线一直在冲刷。
+ *
+ * 🎯 算法思路：
+ * 1. 排序网络就是一串固定的"比较器"(i, j)：执行后保证 a[i] <= a[j]
+ * 2. 比较器的顺序跟数据无关，所以可以在编译期生成、完全展开
+ * 3. 每个比较器只做 min/max，编译成条件传送 (cmov)，没有跳转 (¬‿¬)
+ * 4. 快速排序递归到长度 <= 32 时，直接交给对应长度的网络
+ *
+ * 🔧 网络从哪来：
+ * - 2~9、16 路：抄已知最优表（比较器最少）
+ * - 10~15 路：把 16 路网络里碰到越界位置的比较器删掉
+ *   （越界位置当成 +∞，这些比较器本来就什么都不做）
+ * - 17~32 路：constexpr 生成 Batcher 奇偶归并网络，同样裁剪
+ *
+ * ⏱️ 时间复杂度：
+ * - 单个网络：O(比较器数)，32 路是 191 次 min/max
+ * - 整体快速排序：仍是 O(n log n) 平均，只是常数变小
+ * 💾 空间复杂度：O(1) - 原地，网络表是编译期常量
+ *
+ * 🌟 要点：
+ * - 比较次数比插入排序多，但没有分支预测失败，随机数据上反而更快 (ﾉ◕ヮ◕)ﾉ
+ * - 已经有序的小数组上插入排序只需 n-1 次比较，网络就吃亏了 ┐(´-｀)┌
+ */
@@ -0,0 +1,430 @@
+#include "utility.h"
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace algo;
+
+// 小于这个长度直接插入排序
+const int INSERTION_SORT_THRESHOLD = 24;
+// 大于这个长度用"九数取中"选基准
+const int NINTHER_THRESHOLD = 128;
+// 局部插入排序最多允许移动的次数，超过就放弃
+const int PARTIAL_INSERTION_SORT_LIMIT = 8;
+
+/*
+ * 下面的辅助函数都用左闭右开区间 [begin, end)，
+ * 对外的 PdqSort(R, s, t) 和 Code03 一样用闭区间 [s, t]。
+ */
+
+void InsertionSort(vector<int> & R, int begin, int end) {
+    for (int i = begin + 1; i < end; i++) {
+        int key = R[i];
+        int j = i - 1;
+        while (j >= begin && R[j] > key) {
+            R[j + 1] = R[j];
+            j--;
+        }
+        R[j + 1] = key;
+    }
+}
+
+// 插入排序，但移动次数超过上限就立即放弃（返回 false）
+bool PartialInsertionSort(vector<int> & R, int begin, int end) {
+    int moves = 0;
+    for (int i = begin + 1; i < end; i++) {
+        int key = R[i];
+        int j = i - 1;
+        while (j >= begin && R[j] > key) {
+            R[j + 1] = R[j];
+            j--;
+        }
+        R[j + 1] = key;
+        moves += i - 1 - j;
+
+        if (moves > PARTIAL_INSERTION_SORT_LIMIT) {
+            return false;
+        }
+    }
+    return true;
+}
+
+void HeapSort(vector<int> & R, int begin, int end) {
+    make_heap(R.begin() + begin, R.begin() + end);
+    sort_heap(R.begin() + begin, R.begin() + end);
+}
+
+void Sort2(vector<int> & R, int a, int b) {
+    if (R[b] < R[a]) swap(R[a], R[b]);
+}
+
+// 三个位置排好序，中间值落在 b
+void Sort3(vector<int> & R, int a, int b, int c) {
+    Sort2(R, a, b);
+    Sort2(R, b, c);
+    Sort2(R, a, b);
+}
+
+/**
+ * @brief 以 R[begin] 为基准划分，等于基准的元素放右边
+ * @param already_partitioned 输出：划分过程中一次交换都没有发生
+ * @return 基准最终位置
+ *
+ * 调用前保证 R[end-1] >= 基准（三数取中的副作用），左右扫描都不会越界。
+ */
+int PartitionRight(vector<int> & R, int begin, int end, bool & already_partitioned) {
+    int base = R[begin];
+    int first = begin, last = end;
+
+    while (R[++first] < base);
+
+    // 左边第一个元素就 >= 基准时，右扫描可能一路走到 first，需要加边界
+    if (first - 1 == begin) {
+        while (first < last && !(R[--last] < base));
+    } else {
+        while (!(R[--last] < base));
+    }
+
+    already_partitioned = first >= last;
+
+    while (first < last) {
+        swap(R[first], R[last]);
+        while (R[++first] < base);
+        while (!(R[--last] < base));
+    }
+
+    int pivot_pos = first - 1;
+    R[begin] = R[pivot_pos];
+    R[pivot_pos] = base;
+    return pivot_pos;
+}
+
+/**
+ * @brief 以 R[begin] 为基准划分，等于基准的元素放左边
+ *
+ * 只在基准等于左边界外那个元素时使用：此时左边全是等于基准的值，
+ * 一次划分就能把它们全部排除，大量重复元素时是 O(n)。
+ */
+int PartitionLeft(vector<int> & R, int begin, int end) {
+    int base = R[begin];
+    int first = begin, last = end;
+
+    while (base < R[--last]);
+
+    if (last + 1 == end) {
+        while (first < last && !(base < R[++first]));
+    } else {
+        while (!(base < R[++first]));
+    }
+
+    while (first < last) {
+        swap(R[first], R[last]);
+        while (base < R[--last]);
+        while (!(base < R[++first]));
+    }
+
+    int pivot_pos = last;
+    R[begin] = R[pivot_pos];
+    R[pivot_pos] = base;
+    return pivot_pos;
+}
+
+// 划分很不均匀时，把两侧几个固定位置的元素换一换，打乱可能的"坏模式"
+void BreakPatterns(vector<int> & R, int begin, int pivot_pos, int end) {
+    int l_size = pivot_pos - begin;
+    int r_size = end - (pivot_pos + 1);
+
+    if (l_size >= INSERTION_SORT_THRESHOLD) {
+        swap(R[begin], R[begin + l_size / 4]);
+        swap(R[pivot_pos - 1], R[pivot_pos - l_size / 4]);
+
+        if (l_size > NINTHER_THRESHOLD) {
+            swap(R[begin + 1], R[begin + (l_size / 4 + 1)]);
+            swap(R[begin + 2], R[begin + (l_size / 4 + 2)]);
+            swap(R[pivot_pos - 2], R[pivot_pos - (l_size / 4 + 1)]);
+            swap(R[pivot_pos - 3], R[pivot_pos - (l_size / 4 + 2)]);
+        }
+    }
+
+    if (r_size >= INSERTION_SORT_THRESHOLD) {
+        swap(R[pivot_pos + 1], R[pivot_pos + (1 + r_size / 4)]);
+        swap(R[end - 1], R[end - r_size / 4]);
+
+        if (r_size > NINTHER_THRESHOLD) {
+            swap(R[pivot_pos + 2], R[pivot_pos + (2 + r_size / 4)]);
+            swap(R[pivot_pos + 3], R[pivot_pos + (3 + r_size / 4)]);
+            swap(R[end - 2], R[end - (1 + r_size / 4)]);
+            swap(R[end - 3], R[end - (2 + r_size / 4)]);
+        }
+    }
+}
+
+/**
+ * @brief pdqsort 主循环：右半边用循环代替递归
+ * @param bad_allowed 还允许出现几次严重不均匀的划分，用完就改用堆排序
+ * @param leftmost 当前区间是否在整个数组最左边（左边界外没有元素）
+ */
+void PdqSortLoop(vector<int> & R, int begin, int end, int bad_allowed, bool leftmost) {
+    while (true) {
+        int size = end - begin;
+
+        if (size < INSERTION_SORT_THRESHOLD) {
+            InsertionSort(R, begin, end);
+            return;
+        }
+
+        // 选基准并放到 begin
+        int s2 = size / 2;
+        if (size > NINTHER_THRESHOLD) {
+            Sort3(R, begin, begin + s2, end - 1);
+            Sort3(R, begin + 1, begin + (s2 - 1), end - 2);
+            Sort3(R, begin + 2, begin + (s2 + 1), end - 3);
+            Sort3(R, begin + (s2 - 1), begin + s2, begin + (s2 + 1));
+            swap(R[begin], R[begin + s2]);
+        } else {
+            Sort3(R, begin + s2, begin, end - 1);
+        }
+
+        // 基准和左边界外的元素相等：左边全是重复值，一次性排除
+        if (!leftmost && !(R[begin - 1] < R[begin])) {
+            begin = PartitionLeft(R, begin, end) + 1;
+            continue;
+        }
+
+        bool already_partitioned = false;
+        int pivot_pos = PartitionRight(R, begin, end, already_partitioned);
+
+        int l_size = pivot_pos - begin;
+        int r_size = end - (pivot_pos + 1);
+        bool highly_unbalanced = l_size < size / 8 || r_size < size / 8;
+
+        if (highly_unbalanced) {
+            if (--bad_allowed == 0) {
+                HeapSort(R, begin, end);
+                return;
+            }
+            BreakPatterns(R, begin, pivot_pos, end);
+        } else if (already_partitioned
+                   && PartialInsertionSort(R, begin, pivot_pos)
+                   && PartialInsertionSort(R, pivot_pos + 1, end)) {
+            // 一次交换都没有，说明可能本来就有序：两边各试一次有限的插入排序
+            return;
+        }
+
+        PdqSortLoop(R, begin, pivot_pos, bad_allowed, leftmost);
+        begin = pivot_pos + 1;
+        leftmost = false;
+    }
+}
+
+/**
+ * @brief O(n) 扫描整段：整体有序直接返回，整体逆序原地翻转
+ * @return 已经处理完毕返回 true
+ */
+bool HandleMonotonicRun(vector<int> & R, int s, int t) {
+    int i = s + 1;
+    if (R[i] < R[i - 1]) {
+        while (i <= t && !(R[i - 1] < R[i])) i++;
+        if (i > t) {
+            reverse(R.begin() + s, R.begin() + t + 1);
+            return true;
+        }
+    } else {
+        while (i <= t && !(R[i] < R[i - 1])) i++;
+        if (i > t) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void PdqSort(vector<int> & R, int s, int t) {
+    if (t - s < 1) return;
+    if (HandleMonotonicRun(R, s, t)) return;
+
+    int size = t - s + 1;
+    int log2_size = 0;
+    while (size >>= 1) log2_size++;
+
+    PdqSortLoop(R, s, t + 1, log2_size, true);
+}
+
+// 对照组：Code03 的纯递归快速排序
+int Partition2(vector<int> & R, int s, int t) {
+    int i = s, j = s + 1;
+    int base = R[s];
+
+    while (j <= t) {
+        if (R[j] <= base) {
+            i++;
+            swap(R[i], R[j]);
+        }
+        j++;
+    }
+
+    swap(R[s], R[i]);
+    return i;
+}
+
+void QuickSort(vector<int> & R, int s, int t) {
+    if (s < t) {
+        int pivot = Partition2(R, s, t);
+        QuickSort(R, s, pivot - 1);
+        QuickSort(R, pivot + 1, t);
+    }
+}
+
+int main() {
+    printAlgorithmTitle("模式消除快速排序 (pdqsort)");
+
+    // 测试数据
+    vector<int> test_data = {5, 3, 1, 9, 2, 8, 4, 7, 6, 10};
+
+    cout << "📊 原始数组: ";
+    array_utils::print(test_data, "", 20);
+
+    {
+        auto data_copy = array_utils::copy(test_data);
+        AlgorithmTester tester("pdqsort");
+
+        tester.testPerformance([&]() {
+            PdqSort(data_copy, 0, data_copy.size() - 1);
+        }, test_data.size());
+
+        cout << "📊 排序结果: ";
+        array_utils::print(data_copy, "", 20);
+
+        bool is_correct = array_utils::isSorted(data_copy);
+        cout << "🔍 排序验证: " << (is_correct ? "✅ 正确" : "❌ 错误") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 各种分布 + 随机规模的正确性检查
+    {
+        cout << "💪 随机压力测试:" << endl;
+        validation::stressTest([](vector<int> & data) {
+            PdqSort(data, 0, data.size() - 1);
+        }, 2000, 300);
+
+        bool valid = true;
+        for (size_t size : {1, 2, 3, 50, 1000, 100000}) {
+            vector<vector<int>> inputs = {
+                array_utils::generateSorted(size),
+                array_utils::generateReverse(size, static_cast<int>(size)),
+                array_utils::generateNearlySorted(size, 0.01),
+                array_utils::generateRandom(size, 1, 5),
+            };
+            for (auto & data : inputs) {
+                auto expected = array_utils::copy(data);
+                sort(expected.begin(), expected.end());
+                PdqSort(data, 0, data.size() - 1);
+                valid = valid && data == expected;
+            }
+        }
+        cout << "   有序/逆序/近乎有序/大量重复: " << (valid ? "✅" : "❌") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 不同数据分布：Code03 的最坏情况在这里变成 O(n)
+    {
+        cout << "📈 不同数据分布测试 (10000 个元素，含 Code03 对照):" << endl;
+        size_t test_size = 10000;
+
+        vector<pair<string, vector<int>>> inputs = {
+            {"随机数据", array_utils::generateRandom(test_size, 1, 1000000)},
+            {"已排序数据", array_utils::generateSorted(test_size)},
+            {"逆序数据", array_utils::generateReverse(test_size, static_cast<int>(test_size))},
+            {"近乎有序数据", array_utils::generateNearlySorted(test_size, 0.01)},
+        };
+
+        for (auto & input : inputs) {
+            auto a = array_utils::copy(input.second);
+            auto b = array_utils::copy(input.second);
+
+            cout << "\n   " << input.first << endl;
+            AlgorithmTester tester(input.first);
+            tester.compareAlgorithms(
+                {"Code03 快速排序", "pdqsort"},
+                [&]() { QuickSort(a, 0, a.size() - 1); },
+                [&]() { PdqSort(b, 0, b.size() - 1); });
+        }
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 大规模：和 std::sort 对比，看有序输入是否线性
+    {
+        cout << "📈 大规模对比 (1000000 个元素，对照 std::sort):" << endl;
+        size_t test_size = 1000000;
+
+        vector<pair<string, vector<int>>> inputs = {
+            {"随机数据", array_utils::generateRandom(test_size, 1, 1000000000)},
+            {"已排序数据", array_utils::generateSorted(test_size)},
+            {"逆序数据", array_utils::generateReverse(test_size, static_cast<int>(test_size))},
+            {"近乎有序数据", array_utils::generateNearlySorted(test_size, 0.001)},
+            {"大量重复", array_utils::generateRandom(test_size, 1, 16)},
+        };
+
+        for (auto & input : inputs) {
+            auto a = array_utils::copy(input.second);
+            auto b = array_utils::copy(input.second);
+
+            cout << "\n   " << input.first << endl;
+            AlgorithmTester tester(input.first);
+            tester.compareAlgorithms(
+                {"std::sort", "pdqsort"},
+                [&]() { sort(a.begin(), a.end()); },
+                [&]() { PdqSort(b, 0, b.size() - 1); });
+
+            cout << "   验证: " << (a == b ? "✅" : "❌") << endl;
+        }
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 算法特性:" << endl;
+    cout << "   • 时间复杂度:" << endl;
+    cout << "     - 有序 / 逆序: O(n) - 一次扫描识别" << endl;
+    cout << "     - 平均情况: O(n log n)" << endl;
+    cout << "     - 最坏情况: O(n log n) - 坏划分太多时退化为堆排序" << endl;
+    cout << "   • 空间复杂度: O(log n) - 右半边循环，坏划分次数有上限" << endl;
+    cout << "   • 稳定性: 不稳定" << endl;
+    cout << "   • 自适应:" << endl;
+    cout << "     - 划分时一次交换都没有 → 试一次有限的插入排序" << endl;
+    cout << "     - 划分严重不均 → 打乱固定位置，破坏坏模式" << endl;
+    cout << "     - 大量重复 → 等于基准的元素一次性排除" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - pdqsort（模式消除快速排序）
+ *
+ * Code03 的快速排序碰到有序、逆序数据就退化成 O(n²) (╥_╥)
+ * 可现实里的数据偏偏大多"差不多有序"，比如追加写的日志。
+ * pdqsort 的思路是：别假装数据是随机的，先看看它长什么样。
+ *
+ * 🎯 算法思路：
+ * 1. 先 O(n) 扫一遍：整体有序直接结束，整体逆序翻转一下就结束
+ * 2. 小区间（< 24）直接插入排序
+ * 3. 基准用三数取中，大区间用"九数取中"，有序数据也能选到真正的中位数
+ * 4. 划分时如果一次交换都没做，说明这段很可能本来就有序：
+ *    两边各跑一次"最多移动 8 次"的插入排序，成功就直接收工 (¬‿¬)
+ * 5. 划分严重不均（一侧不到 1/8）时，把两侧几个固定位置的元素换一换，
+ *    打破会一直骗过三数取中的"坏模式"
+ * 6. 坏划分次数超过 log n，就改用堆排序兜底，最坏也是 O(n log n)
+ * 7. 如果基准和区间左边那个元素相等，说明左边是一堆重复值，
+ *    用 PartitionLeft 一次全部排除
+ *
+ * ⏱️ 时间复杂度：
+ * - 有序 / 逆序：O(n)
+ * - 近乎有序：接近 O(n)，每段局部插入排序很快就成功
+ * - 平均：O(n log n)，最坏：O(n log n)
+ * 💾 空间复杂度：O(log n) - 右半边用循环代替递归，坏划分次数有上限
+ *
+ * 🌟 要点：
+ * - 随机数据上和普通快速排序一样快，没有额外开销 (ﾉ◕ヮ◕)ﾉ
+ * - "自适应"的检查都是顺手做的：划分本来就要扫一遍，顺便记下有没有交换
+ */
@@ -0,0 +1,209 @@
+#include "utility.h"
+#include <vector>
+#include <iostream>
+
+using namespace std;
+using namespace algo;
+
+// 挖坑填数法（同 Code01）
+template<typename Policy = NoOpPolicy>
+int Partition1(vector<int> & R, int s, int t) {
+    int i = s, j = t;
+    int base = R[s];
+
+    while (i < j) {
+        while (i < j && Policy::compare(R[j] >= base)) {
+            j--;
+        }
+        if (i < j) {
+            R[i] = R[j];
+            Policy::move();
+            i++;
+        }
+
+        while (i < j && Policy::compare(R[i] <= base)) {
+            i++;
+        }
+        if (i < j) {
+            R[j] = R[i];
+            Policy::move();
+            j--;
+        }
+    }
+
+    R[i] = base;
+    Policy::move();
+    return i;
+}
+
+// 双指针法（同 Code02）
+template<typename Policy = NoOpPolicy>
+int Partition2(vector<int> & R, int s, int t) {
+    int i = s, j = s + 1;
+    int base = R[s];
+
+    while (j <= t) {
+        if (Policy::compare(R[j] <= base)) {
+            i++;
+            swap(R[i], R[j]);
+            Policy::swap();
+        }
+        j++;
+    }
+
+    swap(R[s], R[i]);
+    Policy::swap();
+    return i;
+}
+
+template<typename Policy = NoOpPolicy>
+void QuickSort1(vector<int> & R, int s, int t) {
+    Policy::enter();
+    if (s < t) {
+        int pivot = Partition1<Policy>(R, s, t);
+        QuickSort1<Policy>(R, s, pivot - 1);
+        QuickSort1<Policy>(R, pivot + 1, t);
+    }
+    Policy::leave();
+}
+
+template<typename Policy = NoOpPolicy>
+void QuickSort2(vector<int> & R, int s, int t) {
+    Policy::enter();
+    if (s < t) {
+        int pivot = Partition2<Policy>(R, s, t);
+        QuickSort2<Policy>(R, s, pivot - 1);
+        QuickSort2<Policy>(R, pivot + 1, t);
+    }
+    Policy::leave();
+}
+
+/**
+ * @brief 一行统计：不插桩跑一次计时，插桩再跑一次计数
+ */
+template<typename TimedSort, typename CountedSort>
+void printRow(const string & name, const vector<int> & input,
+              TimedSort timed_sort, CountedSort counted_sort) {
+    auto timed = array_utils::copy(input);
+    auto start = chrono::high_resolution_clock::now();
+    timed_sort(timed);
+    auto end = chrono::high_resolution_clock::now();
+    long long us = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+    auto counted = array_utils::copy(input);
+    CountingPolicy::reset();
+    counted_sort(counted);
+    const OpStats & stats = CountingPolicy::stats();
+
+    bool valid = array_utils::isSorted(timed) && array_utils::isSorted(counted);
+
+    cout << "   " << alignLeft(name, 12)
+         << setw(10) << us
+         << setw(12) << stats.comparisons
+         << setw(10) << stats.moves
+         << setw(10) << stats.swaps
+         << setw(12) << (stats.moves + 2 * stats.swaps)
+         << setw(8) << stats.max_depth
+         << setw(12) << MemoryAnalyzer().formatMemorySize(stats.max_stack_bytes)
+         << "  " << (valid ? "✅" : "❌") << endl;
+}
+
+void printHeader() {
+    cout << "   " << alignLeft("算法", 12)
+         << alignRight("时间(μs)", 10)
+         << alignRight("比较", 12)
+         << alignRight("移动", 10)
+         << alignRight("交换", 10)
+         << alignRight("数组写入", 12)
+         << alignRight("深度", 8)
+         << alignRight("栈空间", 12) << endl;
+}
+
+int main() {
+    printAlgorithmTitle("Partition1 vs Partition2 操作计数对比");
+
+    // 测试数据
+    vector<int> arr = {5, 3, 1, 9, 2, 8, 4, 7, 6};
+
+    cout << "📊 原始数组: ";
+    array_utils::print(arr, "", 20);
+
+    // 单次划分
+    {
+        AlgorithmTester tester1("Partition1");
+        auto a = array_utils::copy(arr);
+        auto a_timed = array_utils::copy(arr);
+        tester1.testPerformanceCounted(
+            [&]() { Partition1(a_timed, 0, a_timed.size() - 1); },
+            [&]() { Partition1<CountingPolicy>(a, 0, a.size() - 1); },
+            a.size());
+
+        AlgorithmTester tester2("Partition2");
+        auto b = array_utils::copy(arr);
+        auto b_timed = array_utils::copy(arr);
+        tester2.testPerformanceCounted(
+            [&]() { Partition2(b_timed, 0, b_timed.size() - 1); },
+            [&]() { Partition2<CountingPolicy>(b, 0, b.size() - 1); },
+            b.size());
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 完整快速排序：不同规模 × 不同分布
+    {
+        cout << "📈 快速排序操作计数（数组写入 = 移动 + 2 × 交换）:" << endl;
+
+        for (size_t size : {1000, 10000}) {
+            vector<pair<string, vector<int>>> inputs = {
+                {"随机数据", array_utils::generateRandom(size, 1, 1000000)},
+                {"大量重复", array_utils::generateRandom(size, 1, 10)},
+                {"已排序数据", array_utils::generateSorted(size)},
+                {"逆序数据", array_utils::generateReverse(size, static_cast<int>(size))},
+            };
+
+            for (auto & input : inputs) {
+                cout << "\n   " << input.first << " (" << size << " 个元素)" << endl;
+                printHeader();
+                printRow("Partition1", input.second,
+                         [](vector<int> & v) { QuickSort1(v, 0, v.size() - 1); },
+                         [](vector<int> & v) { QuickSort1<CountingPolicy>(v, 0, v.size() - 1); });
+                printRow("Partition2", input.second,
+                         [](vector<int> & v) { QuickSort2(v, 0, v.size() - 1); },
+                         [](vector<int> & v) { QuickSort2<CountingPolicy>(v, 0, v.size() - 1); });
+            }
+        }
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 结论:" << endl;
+    cout << "   • 两种划分的比较次数都是每层 n-1 次左右，差别在写内存" << endl;
+    cout << "   • Partition1 每次只移动一个元素填坑；Partition2 每次都要交换" << endl;
+    cout << "   • 大量重复时 Partition2 把等于基准的都换到左边，划分严重不均" << endl;
+    cout << "   • 已排序/逆序数据两者递归深度都是 n，栈空间随 n 线性增长" << endl;
+    cout << "   • NoOpPolicy 下钩子全是空函数，生成的代码和不插桩完全一样" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - 用插桩策略对比两种划分
+ *
+ * 只看微秒数很难说清两种划分谁好，计时还会被缓存、频率抖动干扰 (◔_◔)
+ * 所以把"比较了几次、写了几次内存、递归多深"直接数出来。
+ *
+ * 🎯 做法：
+ * 1. 划分和排序函数多一个模板参数 Policy，默认是 NoOpPolicy
+ * 2. 算法里在比较、移动、交换、进出递归的地方调用 Policy 的静态钩子
+ * 3. NoOpPolicy 的钩子全是空的 inline 函数，编译后一条指令都不剩 (¬‿¬)
+ * 4. CountingPolicy 的钩子累加计数，enter() 还记下局部变量地址，
+ *    最外层和最深层的地址差就是实测的递归栈空间
+ * 5. 计时用 NoOpPolicy 跑一次，计数用 CountingPolicy 再跑一次，互不干扰
+ *
+ * ⏱️ 时间复杂度：插桩只加常数开销，不改变算法复杂度
+ * 💾 空间复杂度：计数器是几个 thread_local 变量，O(1)
+ *
+ * 🌟 要点：
+ * - 策略是模板参数而不是函数参数，不占寄存器，才能做到真正零开销 (ﾉ◕ヮ◕)ﾉ
+ * - 栈空间是实测值，比按算法名字猜 O(log n) 靠谱多了
+ */
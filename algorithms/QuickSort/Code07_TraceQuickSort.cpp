@@ -0,0 +1,181 @@
+#include "utility.h"
+#include "trace.h"
+#include <vector>
+#include <thread>
+#include <iostream>
+
+using namespace std;
+using namespace algo;
+
+// 小于这个长度的子数组不追踪，避免事件太多把环形缓冲区刷掉
+const int TRACE_MIN_SIZE = 4096;
+// 并行快速排序只在前几层开线程
+const int PARALLEL_DEPTH = 3;
+
+int Partition2(vector<int> & R, int s, int t) {
+    int i = s, j = s + 1;
+    int base = R[s];
+
+    while (j <= t) {
+        if (R[j] <= base) {
+            i++;
+            swap(R[i], R[j]);
+        }
+        j++;
+    }
+
+    swap(R[s], R[i]);
+    return i;
+}
+
+// 不追踪的纯递归快速排序（同 Code03）
+void QuickSortPlain(vector<int> & R, int s, int t) {
+    if (s < t) {
+        int pivot = Partition2(R, s, t);
+        QuickSortPlain(R, s, pivot - 1);
+        QuickSortPlain(R, pivot + 1, t);
+    }
+}
+
+// 追踪版：每个足够大的子数组记录一个 QuickSort 区间，里面嵌套 Partition2 区间
+void QuickSort(vector<int> & R, int s, int t) {
+    int n = t - s + 1;
+    if (n < TRACE_MIN_SIZE) {
+        QuickSortPlain(R, s, t);
+        return;
+    }
+
+    TRACE_SCOPE("QuickSort", n);
+    int pivot;
+    {
+        TRACE_SCOPE("Partition2", n);
+        pivot = Partition2(R, s, t);
+    }
+    QuickSort(R, s, pivot - 1);
+    QuickSort(R, pivot + 1, t);
+}
+
+// 并行版：前 PARALLEL_DEPTH 层把左半边交给新线程
+void ParallelQuickSort(vector<int> & R, int s, int t, int depth = 0) {
+    int n = t - s + 1;
+    if (depth >= PARALLEL_DEPTH || n < TRACE_MIN_SIZE) {
+        QuickSort(R, s, t);
+        return;
+    }
+
+    TRACE_SCOPE("ParallelQuickSort", n);
+    int pivot;
+    {
+        TRACE_SCOPE("Partition2", n);
+        pivot = Partition2(R, s, t);
+    }
+
+    thread left([&R, s, pivot, depth]() {
+        trace::setThreadName("worker depth " + to_string(depth + 1));
+        ParallelQuickSort(R, s, pivot - 1, depth + 1);
+    });
+    ParallelQuickSort(R, pivot + 1, t, depth + 1);
+    left.join();
+}
+
+int main() {
+    printAlgorithmTitle("快速排序 + 事件追踪 (Chrome Trace)");
+
+    trace::setThreadName("main");
+    trace::exportAtExit("quicksort_trace.json");
+
+    // 单个区间的开销：走实际的 TRACE_SCOPE → 线程缓冲区路径，连续记录 100 万个区间
+    {
+        cout << "⏱️ 追踪开销测试:" << endl;
+        const int iterations = 1000000;
+
+        // 缓冲区在 setThreadName 时已注册并预先触碰，先空跑一圈让它进缓存
+        for (int i = 0; i < static_cast<int>(trace::kRingCapacity); i++) {
+            TRACE_SCOPE("overhead", i);
+        }
+
+        auto start = chrono::high_resolution_clock::now();
+        for (int i = 0; i < iterations; i++) {
+            TRACE_SCOPE("overhead", i);
+        }
+        auto end = chrono::high_resolution_clock::now();
+
+        // 测试事件不进入导出的 trace
+        trace::localBuffer().clear();
+
+        double ns = chrono::duration<double, nano>(end - start).count() / iterations;
+        cout << "   每个区间(开始+结束): " << fixed << setprecision(1) << ns << " ns" << endl;
+        cout << "   每个事件: " << ns / 2 << " ns" << endl;
+        cout.unsetf(ios::fixed);
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 串行：追踪递归结构
+    {
+        auto data = array_utils::generateRandom(1000000, 1, 1000000000);
+        auto plain = array_utils::copy(data);
+
+        AlgorithmTester tester("快速排序");
+        tester.compareAlgorithms(
+            {"不追踪", "追踪 (>= 4096 的子数组)"},
+            [&]() { QuickSortPlain(plain, 0, plain.size() - 1); },
+            [&]() {
+                TRACE_SCOPE("串行快速排序");
+                QuickSort(data, 0, data.size() - 1);
+            });
+
+        bool valid = array_utils::isSorted(data) && array_utils::isSorted(plain);
+        cout << "🔍 排序验证: " << (valid ? "✅ 正确" : "❌ 错误") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 并行：追踪任务在各线程上的分布
+    {
+        auto data = array_utils::generateRandom(1000000, 1, 1000000000);
+
+        Timer timer("并行快速排序 (" + to_string(1 << PARALLEL_DEPTH) + " 个任务)");
+        {
+            TRACE_SCOPE("并行快速排序");
+            ParallelQuickSort(data, 0, data.size() - 1);
+        }
+        timer.stop();
+
+        bool valid = array_utils::isSorted(data);
+        cout << "🔍 排序验证: " << (valid ? "✅ 正确" : "❌ 错误") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 使用说明:" << endl;
+    cout << "   • 程序退出时写出 quicksort_trace.json" << endl;
+    cout << "   • 用 chrome://tracing 或 https://ui.perfetto.dev 打开" << endl;
+    cout << "   • 每个线程一行，嵌套的区间就是递归结构" << endl;
+    cout << "   • 定义 ALGO_TRACE_DISABLED 后追踪代码全部编译为空" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - 环形缓冲区事件追踪
+ *
+ * Timer 在析构时直接往 std::cout 打印，嵌套计时的话外层会把内层的 I/O 也算进去，
+ * 多线程一起打印还会串行 (╯°□°）╯
+ *
+ * 🎯 思路：
+ * 1. 热路径上只"记账"不输出：每个线程一块环形缓冲区，
+ *    一条事件 = 名字指针 + rdtsc 时间戳 + 参数 + 开始/结束标记
+ * 2. 只有所属线程写自己的缓冲区，写完用 release 发布下标，不需要锁
+ * 3. TRACE_SCOPE 是 RAII：构造记开始，析构记结束，天然配对、天然嵌套
+ * 4. 缓冲区写满就覆盖最旧的事件，内存占用固定；线程退出时只留下实际记录的事件，
+ *    缓冲区交给之后新建的线程复用，每个任务开一个线程也不会越占越多
+ * 5. 程序退出时统一换算时间（TSC 周期 → 微秒），写成 Chrome Trace JSON (¬‿¬)
+ *
+ * ⏱️ 时间复杂度：每个事件 O(1)，实测十几纳秒（大头是读时间戳）
+ * 💾 空间复杂度：每个存活线程 kRingCapacity 个事件，已退出线程只占实际记录的事件
+ *
+ * 🌟 要点：
+ * - 递归太深的小区间不追踪，否则几百万个事件会把有用的部分覆盖掉
+ * - 在 Perfetto 里能直接看到并行快速排序前几层的任务是怎么分到各线程上的 (ﾉ◕ヮ◕)ﾉ
+ */
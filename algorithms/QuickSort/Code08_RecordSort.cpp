@@ -0,0 +1,345 @@
+#include "utility.h"
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+using namespace algo;
+
+/*
+ * 快速排序引擎：和 Code03 一样的 Partition2 + 递归，
+ * 只是元素类型和"取键"方式做成模板参数，记录、(键, 下标) 对都能用。
+ */
+
+template<typename T, typename KeyOf>
+int Partition2(vector<T> & R, int s, int t, KeyOf key) {
+    int i = s, j = s + 1;
+    auto base = key(R[s]);
+
+    while (j <= t) {
+        if (key(R[j]) <= base) {
+            i++;
+            swap(R[i], R[j]);
+        }
+        j++;
+    }
+
+    swap(R[s], R[i]);
+    return i;
+}
+
+template<typename T, typename KeyOf>
+void QuickSort(vector<T> & R, int s, int t, KeyOf key) {
+    if (s < t) {
+        int pivot = Partition2(R, s, t, key);
+        QuickSort(R, s, pivot - 1, key);
+        QuickSort(R, pivot + 1, t, key);
+    }
+}
+
+// 预取地址 p 开始的 bytes 字节（逐个缓存行）
+inline void PrefetchBytes(const void * p, size_t bytes) {
+#if defined(__GNUC__) || defined(__clang__)
+    const char * c = static_cast<const char *>(p);
+    for (size_t offset = 0; offset < bytes; offset += 64) {
+        __builtin_prefetch(c + offset);
+    }
+#else
+    (void)p;
+    (void)bytes;
+#endif
+}
+
+// 键 + 原始下标，8 字节，交换起来很便宜
+struct KeyIndex {
+    int key;
+    uint32_t index;
+};
+
+/**
+ * @brief 模式一：直接排序记录，每次交换都搬动整条记录
+ */
+template<typename T, typename KeyOf>
+void SortRecordsDirect(vector<T> & records, KeyOf key) {
+    QuickSort(records, 0, static_cast<int>(records.size()) - 1, key);
+}
+
+/**
+ * @brief 把 (键, 原下标) 打包后排序
+ */
+template<typename T, typename KeyOf>
+vector<KeyIndex> SortedPairs(const vector<T> & records, KeyOf key) {
+    vector<KeyIndex> pairs(records.size());
+    for (size_t i = 0; i < records.size(); i++) {
+        pairs[i] = {key(records[i]), static_cast<uint32_t>(i)};
+    }
+
+    QuickSort(pairs, 0, static_cast<int>(pairs.size()) - 1,
+              [](const KeyIndex & p) { return p.key; });
+    return pairs;
+}
+
+inline vector<uint32_t> ToPermutation(const vector<KeyIndex> & pairs) {
+    vector<uint32_t> perm(pairs.size());
+    for (size_t i = 0; i < pairs.size(); i++) {
+        perm[i] = pairs[i].index;
+    }
+    return perm;
+}
+
+/**
+ * @brief 只排 (键, 下标)，返回排序后的下标序列
+ * @return perm，满足 排序结果[i] = records[perm[i]]
+ */
+template<typename T, typename KeyOf>
+vector<uint32_t> SortedIndex(const vector<T> & records, KeyOf key) {
+    return ToPermutation(SortedPairs(records, key));
+}
+
+// 沿置换环向前看几步做预取
+const int PERMUTE_PREFETCH_DISTANCE = 8;
+
+/**
+ * @brief 按置换原地重排：R[i] ← R[perm[i]]，沿环搬动，每条记录只搬一次
+ *
+ * 环上的访问顺序由 perm 决定，是随机的；所以维护一个领先
+ * PERMUTE_PREFETCH_DISTANCE 步的"探子"，提前把后面要搬的记录预取进缓存。
+ * perm 会被用作"已访问"标记（处理完的位置置为 perm[j] = j）。
+ */
+template<typename T>
+void ApplyPermutation(vector<T> & R, vector<uint32_t> & perm) {
+    for (uint32_t i = 0; i < perm.size(); i++) {
+        if (perm[i] == i) continue;
+
+        uint32_t ahead = i;
+        for (int d = 0; d < PERMUTE_PREFETCH_DISTANCE; d++) {
+            ahead = perm[ahead];
+            PrefetchBytes(&R[ahead], sizeof(T));
+        }
+
+        T tmp = std::move(R[i]);
+        uint32_t j = i;
+        while (true) {
+            uint32_t k = perm[j];
+            perm[j] = j;
+            if (k == i) {
+                R[j] = std::move(tmp);
+                break;
+            }
+            R[j] = std::move(R[k]);
+            j = k;
+
+            ahead = perm[ahead];
+            PrefetchBytes(&R[ahead], sizeof(T));
+        }
+    }
+}
+
+/**
+ * @brief 模式二：排 (键, 下标)，再按置换原地重排记录
+ */
+template<typename T, typename KeyOf>
+void SortRecordsByIndex(vector<T> & records, KeyOf key) {
+    vector<uint32_t> perm = SortedIndex(records, key);
+    ApplyPermutation(records, perm);
+}
+
+/**
+ * @brief 模式三：结构数组（SoA），键和各负载列分开存放，一起按键排序
+ *
+ * 排序只碰键列（打包成 (键, 下标)）；排好的键直接顺序写回，
+ * 每个负载列再各自按同一个置换原地重排。
+ */
+template<typename... Columns>
+void SortColumns(vector<int> & keys, Columns &... columns) {
+    vector<KeyIndex> pairs = SortedPairs(keys, [](int k) { return k; });
+    for (size_t i = 0; i < pairs.size(); i++) {
+        keys[i] = pairs[i].key;
+    }
+
+    vector<uint32_t> perm = ToPermutation(pairs);
+    vector<uint32_t> scratch;
+    auto permute = [&](auto & column) {
+        scratch = perm;  // ApplyPermutation 会改写置换，每列用一份拷贝
+        ApplyPermutation(column, scratch);
+    };
+    (permute(columns), ...);
+}
+
+// 测试用记录：int 键 + 负载，总大小 Size 字节
+template<size_t Size>
+struct Record {
+    int key;
+    unsigned char payload[Size - sizeof(int)];
+};
+
+template<size_t Size>
+struct Payload {
+    unsigned char bytes[Size - sizeof(int)];
+};
+
+// 负载内容由键决定，排序后可以据此检查记录有没有搬错
+template<typename P>
+void FillPayload(P & p, int key) {
+    for (size_t i = 0; i < sizeof(p); i++) {
+        reinterpret_cast<unsigned char *>(&p)[i] = static_cast<unsigned char>(key + i);
+    }
+}
+
+template<typename P>
+bool CheckPayload(const P & p, int key) {
+    for (size_t i = 0; i < sizeof(p); i += 16) {
+        if (reinterpret_cast<const unsigned char *>(&p)[i] != static_cast<unsigned char>(key + i)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<size_t Size>
+void BenchmarkPayload(size_t n) {
+    cout << "\n   记录大小: " << Size << " 字节，" << n << " 条" << endl;
+
+    auto keys = array_utils::generateRandom(n, 1, 1000000000);
+    auto key_of = [](const Record<Size> & r) { return r.key; };
+
+    vector<Record<Size>> direct(n);
+    for (size_t i = 0; i < n; i++) {
+        direct[i].key = keys[i];
+        FillPayload(direct[i].payload, keys[i]);
+    }
+    vector<Record<Size>> indexed = direct;
+
+    vector<int> soa_keys = keys;
+    vector<Payload<Size>> soa_payload(n);
+    for (size_t i = 0; i < n; i++) {
+        FillPayload(soa_payload[i], keys[i]);
+    }
+
+    AlgorithmTester tester("记录排序");
+    tester.compareAlgorithms(
+        {"直接排序记录", "(键,下标) + 原地置换", "结构数组 (SoA)"},
+        [&]() { SortRecordsDirect(direct, key_of); },
+        [&]() { SortRecordsByIndex(indexed, key_of); },
+        [&]() { SortColumns(soa_keys, soa_payload); });
+
+    bool valid = true;
+    for (size_t i = 0; i < n && valid; i++) {
+        valid = (i == 0 || direct[i - 1].key <= direct[i].key)
+                && direct[i].key == indexed[i].key && indexed[i].key == soa_keys[i]
+                && CheckPayload(direct[i].payload, direct[i].key)
+                && CheckPayload(indexed[i].payload, indexed[i].key)
+                && CheckPayload(soa_payload[i], soa_keys[i]);
+    }
+    cout << "   验证: " << (valid ? "✅" : "❌") << endl;
+}
+
+int main() {
+    printAlgorithmTitle("记录排序：直接排序 / 下标排序 / 结构数组");
+
+    // 小例子：看一下置换是怎么作用的
+    {
+        vector<Record<16>> records(6);
+        vector<int> keys = {50, 20, 40, 10, 60, 30};
+        for (size_t i = 0; i < keys.size(); i++) {
+            records[i].key = keys[i];
+            FillPayload(records[i].payload, keys[i]);
+        }
+
+        auto key_of = [](const Record<16> & r) { return r.key; };
+        vector<uint32_t> perm = SortedIndex(records, key_of);
+
+        cout << "📊 原始键: ";
+        array_utils::print(keys, "", 20);
+        cout << "📊 排序后的下标 perm: ";
+        array_utils::print(perm, "", 20);
+
+        ApplyPermutation(records, perm);
+        vector<int> sorted_keys;
+        for (const auto & r : records) sorted_keys.push_back(r.key);
+
+        cout << "📊 原地置换后的键: ";
+        array_utils::print(sorted_keys, "", 20);
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 正确性：随机规模、大量重复键
+    {
+        cout << "🔍 正确性测试:" << endl;
+        bool valid = true;
+        for (size_t n : {0, 1, 2, 17, 1000, 20000}) {
+            auto keys = array_utils::generateRandom(n, 1, 50);
+
+            vector<Record<64>> records(n);
+            for (size_t i = 0; i < n; i++) {
+                records[i].key = keys[i];
+                FillPayload(records[i].payload, keys[i]);
+            }
+            SortRecordsByIndex(records, [](const Record<64> & r) { return r.key; });
+
+            vector<int> soa_keys = keys;
+            vector<int> soa_column(keys.begin(), keys.end());
+            SortColumns(soa_keys, soa_column);
+
+            for (size_t i = 0; i < n; i++) {
+                valid = valid && (i == 0 || records[i - 1].key <= records[i].key)
+                        && CheckPayload(records[i].payload, records[i].key)
+                        && soa_keys[i] == records[i].key && soa_column[i] == soa_keys[i];
+            }
+        }
+        cout << "   结果: " << (valid ? "✅ 正确" : "❌ 错误") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 不同负载大小下三种模式的对比
+    {
+        cout << "📈 三种模式对比（不同记录大小）:" << endl;
+        const size_t n = 200000;
+        BenchmarkPayload<16>(n);
+        BenchmarkPayload<64>(n);
+        BenchmarkPayload<128>(n);
+        BenchmarkPayload<256>(n);
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 算法特性:" << endl;
+    cout << "   • 直接排序: 每次交换搬动整条记录，O(n log n) 次大块内存搬运" << endl;
+    cout << "   • 下标排序: 只交换 8 字节的 (键, 下标)，最后每条记录只搬一次" << endl;
+    cout << "   • 原地置换: 沿置换环搬动，额外空间只有一条记录 + 下标数组" << endl;
+    cout << "   • 结构数组: 排序只读键列，键顺序写回，负载列各自原地置换" << endl;
+    cout << "   • 记录越大，下标排序和结构数组的优势越明显" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - 大记录排序
+ *
+ * 真实数据往往是"一个整数键 + 一大坨负载"，64~256 字节一条。
+ * 直接用 Partition2 排，每次 swap 都要搬三次整条记录，内存带宽全浪费在负载上了 (╥_╥)
+ *
+ * 🎯 算法思路：
+ * 1. 把快速排序做成模板：元素类型随意，用 key() 取出比较用的键
+ * 2. 下标排序：先把 (键, 原下标) 打包成 8 字节的小结构来排序，
+ *    排完得到置换 perm：第 i 个位置应该放原来的第 perm[i] 条记录
+ * 3. 原地置换：从 i 出发沿着 i → perm[i] → perm[perm[i]] ... 走一个环，
+ *    每一步把后一条记录搬到前一个位置，环尾放回最开始拿出来的那条 (◕‿◕)
+ *    走过的位置把 perm[j] 设成 j，表示已经归位
+ * 4. 环上的访问是随机的，所以派一个"探子"领先 8 步，提前预取后面的记录
+ * 5. 结构数组：键和负载本来就分开存，排序只动键列，
+ *    排好的键直接顺序写回，负载列各自按同一个 perm 原地置换
+ *
+ * ⏱️ 时间复杂度：
+ * - 三种模式的比较次数都是 O(n log n)
+ * - 直接排序搬运 O(n log n) 条大记录；下标排序和结构数组只搬 O(n) 条
+ * 💾 空间复杂度：
+ * - 下标排序：O(n) 个 (键, 下标) + O(n) 的 perm，记录本身原地
+ * - 结构数组：同下标排序，每列多一份 O(n) 的 perm 拷贝
+ *
+ * 🌟 要点：
+ * - 记录小（16 字节）时直接排序还挺快，多出来的一遍置换反而是负担 ┐(´-｀)┌
+ * - 记录越大，"只排小东西，大东西只搬一次"越划算 (ﾉ◕ヮ◕)ﾉ
+ */
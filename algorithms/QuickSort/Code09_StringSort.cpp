@@ -0,0 +1,463 @@
+#include "utility.h"
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <iostream>
+
+using namespace std;
+using namespace algo;
+
+// 小于这个长度的子数组改用插入排序
+const int INSERTION_THRESHOLD = 16;
+// MSD 基数排序的字符种类（一个字节）；另加一个"字符串已结束"的桶
+const int RADIX = 256;
+
+// 基准：和 Code03 一样的 Partition2 + 递归，每次比较都从第一个字符开始
+int Partition2(vector<string> & R, int s, int t) {
+    int i = s, j = s + 1;
+    const string & base = R[s];
+
+    while (j <= t) {
+        if (R[j] <= base) {
+            i++;
+            swap(R[i], R[j]);
+        }
+        j++;
+    }
+
+    swap(R[s], R[i]);
+    return i;
+}
+
+void QuickSort(vector<string> & R, int s, int t) {
+    if (s < t) {
+        int pivot = Partition2(R, s, t);
+        QuickSort(R, s, pivot - 1);
+        QuickSort(R, pivot + 1, t);
+    }
+}
+
+// 把字符串按 order 重新排列（排序都只搬指针，最后一次性搬字符串）
+void ApplyOrder(vector<string> & R, const vector<const string *> & order) {
+    vector<string> sorted;
+    sorted.reserve(R.size());
+    for (const string * p : order) {
+        sorted.push_back(std::move(*const_cast<string *>(p)));
+    }
+    R.swap(sorted);
+}
+
+vector<const string *> Pointers(const vector<string> & R) {
+    vector<const string *> order(R.size());
+    for (size_t i = 0; i < R.size(); i++) {
+        order[i] = &R[i];
+    }
+    return order;
+}
+
+// 从第 depth 个字符开始比较（调用方保证两者的前 depth 个字符相同）
+int CompareFrom(const string & a, const string & b, size_t depth) {
+    return a.compare(depth, string::npos, b, depth, string::npos);
+}
+
+// 从第 depth 个字符开始的公共前缀长度
+size_t LcpFrom(const string & a, const string & b, size_t depth) {
+    size_t n = min(a.size(), b.size());
+    while (depth < n && a[depth] == b[depth]) depth++;
+    return depth;
+}
+
+// R[s..t] 从 depth 开始还有多长的公共前缀（整段落在同一个桶里时一次跳过去）
+template<typename GetString>
+size_t CommonPrefixFrom(int s, int t, size_t depth, GetString get) {
+    const string & first = get(s);
+    size_t common = first.size();
+    for (int i = s + 1; i <= t && common > depth; i++) {
+        common = min(common, LcpFrom(first, get(i), depth));
+    }
+    return common;
+}
+
+/*
+ * 三路基数快速排序（Multikey QuickSort）+ 键前缀缓存
+ *
+ * 每个元素带一个 8 字节的缓存：从 depth 开始的 8 个字符按大端拼成一个整数，
+ * 划分时只比较这个整数，不用再去访问字符串本身。
+ */
+
+struct CachedString {
+    uint64_t cache;     // 从 depth 开始的 8 个字符，字符串结束后补 0
+    const string * str;
+};
+
+// 读出从 depth 开始的 8 个字符
+// 结束后补的 0 和真正的 '\0' 在缓存里分不出来，缓存相等时要再看长度（CompareAfterCache）
+inline uint64_t LoadKey(const string & s, size_t depth) {
+    uint64_t key = 0;
+    for (size_t i = 0; i < 8; i++) {
+        unsigned char c = depth + i < s.size() ? static_cast<unsigned char>(s[depth + i]) : 0;
+        key = (key << 8) | c;
+    }
+    return key;
+}
+
+/**
+ * @brief 缓存相同的两个字符串比较剩下的部分
+ *
+ * 有一个在这 8 个字符内结束时，它一定是另一个的前缀（另一个在对应位置上只能是 '\0'），
+ * 短的排前面；否则从 depth + 8 接着比。
+ */
+inline int CompareAfterCache(const string & a, const string & b, size_t depth) {
+    if (min(a.size(), b.size()) <= depth + 8) {
+        return (a.size() > b.size()) - (a.size() < b.size());
+    }
+    return CompareFrom(a, b, depth + 8);
+}
+
+void InsertionSortFrom(vector<CachedString> & R, int s, int t, size_t depth) {
+    for (int i = s + 1; i <= t; i++) {
+        CachedString x = R[i];
+        int j = i - 1;
+        while (j >= s && (R[j].cache > x.cache ||
+                          (R[j].cache == x.cache && CompareAfterCache(*R[j].str, *x.str, depth) > 0))) {
+            R[j + 1] = R[j];
+            j--;
+        }
+        R[j + 1] = x;
+    }
+}
+
+uint64_t MedianOfThree(uint64_t a, uint64_t b, uint64_t c) {
+    if (a < b) {
+        if (b < c) return b;
+        return a < c ? c : a;
+    }
+    if (a < c) return a;
+    return b < c ? c : b;
+}
+
+/**
+ * @brief 三路划分：按缓存值把 R[s..t] 分成 < 基准、= 基准、> 基准 三段
+ * @return {lt, gt}，R[lt..gt] 是等于基准的一段
+ */
+pair<int, int> Partition3(vector<CachedString> & R, int s, int t, uint64_t base) {
+    int lt = s, i = s, gt = t;
+    while (i <= gt) {
+        if (R[i].cache < base) {
+            swap(R[lt++], R[i++]);
+        } else if (R[i].cache > base) {
+            swap(R[i], R[gt--]);
+        } else {
+            i++;
+        }
+    }
+    return {lt, gt};
+}
+
+/**
+ * @brief 等于段里把在这 8 个字符内结束的字符串挪到前面，按长度排好
+ *
+ * 它们是段内其余字符串的前缀；没有 '\0' 时它们长度都相同，不用再排。
+ * @return 第一个没有结束的位置
+ */
+int SplitEnded(vector<CachedString> & R, int s, int t, size_t depth) {
+    int mid = s;
+    size_t shortest = string::npos, longest = 0;
+    for (int i = s; i <= t; i++) {
+        size_t len = R[i].str->size();
+        if (len <= depth + 8) {
+            shortest = min(shortest, len);
+            longest = max(longest, len);
+            swap(R[mid++], R[i]);
+        }
+    }
+    if (shortest != longest && mid - s > 1) {
+        sort(R.begin() + s, R.begin() + mid, [](const CachedString & a, const CachedString & b) {
+            return a.str->size() < b.str->size();
+        });
+    }
+    return mid;
+}
+
+/**
+ * @brief 对前 depth 个字符都相同的 R[s..t] 排序，缓存里是从 depth 开始的 8 个字符
+ */
+void MultikeyQuickSort(vector<CachedString> & R, int s, int t, size_t depth) {
+    while (t - s + 1 > INSERTION_THRESHOLD) {
+        uint64_t base = MedianOfThree(R[s].cache, R[s + (t - s) / 2].cache, R[t].cache);
+        auto [lt, gt] = Partition3(R, s, t, base);
+
+        // 小于、大于两段的前 depth 个字符仍然相同，缓存不用变
+        MultikeyQuickSort(R, s, lt - 1, depth);
+        MultikeyQuickSort(R, gt + 1, t, depth);
+
+        // 等于段：8 个字符全相同；最低字节为 0 说明有字符串在窗口内结束（或含 '\0'）
+        if ((base & 0xff) == 0) {
+            s = SplitEnded(R, lt, gt, depth);
+            t = gt;
+            if (s > t) return;
+            depth += 8;
+        } else if (lt == s && gt == t) {
+            // 整段都相等：直接跳过整段的公共前缀，免得每 8 个字符重装一次缓存
+            depth = CommonPrefixFrom(s, t, depth, [&](int i) -> const string & { return *R[i].str; });
+        } else {
+            s = lt;
+            t = gt;
+            depth += 8;
+        }
+        for (int i = s; i <= t; i++) {
+            R[i].cache = LoadKey(*R[i].str, depth);
+        }
+    }
+    InsertionSortFrom(R, s, t, depth);
+}
+
+void MultikeyQuickSort(vector<string> & R) {
+    vector<CachedString> items(R.size());
+    for (size_t i = 0; i < R.size(); i++) {
+        items[i] = {LoadKey(R[i], 0), &R[i]};
+    }
+
+    MultikeyQuickSort(items, 0, static_cast<int>(items.size()) - 1, 0);
+
+    vector<const string *> order(items.size());
+    for (size_t i = 0; i < items.size(); i++) {
+        order[i] = items[i].str;
+    }
+    ApplyOrder(R, order);
+}
+
+/*
+ * MSD 基数排序 + LCP 数组
+ *
+ * lcp[i] = 排序后第 i-1 个和第 i 个字符串的最长公共前缀长度（lcp[0] = 0）。
+ * 按第 depth 个字符分桶时，相邻两个桶的交界处公共前缀恰好是 depth，
+ * 所以 LCP 数组在分桶的过程中顺手就填好了。
+ */
+
+// 第 depth 个字符所在的桶：字符串结束记为 0 号桶，字符 c 记为 c + 1 号桶（'\0' 是普通字符）
+inline int BucketAt(const string * s, size_t depth) {
+    return depth < s->size() ? static_cast<unsigned char>((*s)[depth]) + 1 : 0;
+}
+
+void InsertionSortLcp(vector<const string *> & R, vector<size_t> & lcp, int s, int t, size_t depth) {
+    for (int i = s + 1; i <= t; i++) {
+        const string * x = R[i];
+        int j = i - 1;
+        while (j >= s && CompareFrom(*R[j], *x, depth) > 0) {
+            R[j + 1] = R[j];
+            j--;
+        }
+        R[j + 1] = x;
+    }
+    for (int i = s + 1; i <= t; i++) {
+        lcp[i] = LcpFrom(*R[i - 1], *R[i], depth);
+    }
+}
+
+/**
+ * @brief 对前 depth 个字符都相同的 R[s..t] 排序，并填好 lcp[s+1..t]
+ * @param buffer 和 R 一样大的临时数组
+ */
+void MsdRadixSort(vector<const string *> & R, vector<const string *> & buffer,
+                  vector<size_t> & lcp, int s, int t, size_t depth) {
+    if (t - s + 1 <= INSERTION_THRESHOLD) {
+        InsertionSortLcp(R, lcp, s, t, depth);
+        return;
+    }
+
+    // 计数 → 前缀和 → 分配到 buffer → 拷回
+    int count[RADIX + 2] = {0};
+    for (int i = s; i <= t; i++) {
+        count[BucketAt(R[i], depth) + 1]++;
+    }
+
+    // 整段落在同一个字符的桶里：跳过公共前缀，不用逐层分配
+    int only = BucketAt(R[s], depth);
+    if (only != 0 && count[only + 1] == t - s + 1) {
+        depth = CommonPrefixFrom(s, t, depth + 1, [&](int i) -> const string & { return *R[i]; });
+        MsdRadixSort(R, buffer, lcp, s, t, depth);
+        return;
+    }
+
+    for (int c = 0; c <= RADIX; c++) {
+        count[c + 1] += count[c];
+    }
+    for (int i = s; i <= t; i++) {
+        buffer[s + count[BucketAt(R[i], depth)]++] = R[i];
+    }
+    copy(buffer.begin() + s, buffer.begin() + t + 1, R.begin() + s);
+
+    // 现在 count[c] 是桶 c 的结束位置（相对 s）
+    int start = s;
+    for (int c = 0; c <= RADIX; c++) {
+        int end = s + count[c] - 1;
+        if (start > end) continue;
+
+        if (start > s) {
+            lcp[start] = depth;  // 和前一个桶的交界
+        }
+        if (c == 0) {
+            // 长度恰好为 depth 的字符串，彼此完全相同
+            for (int i = start + 1; i <= end; i++) lcp[i] = depth;
+        } else if (start < end) {
+            MsdRadixSort(R, buffer, lcp, start, end, depth + 1);
+        }
+        start = end + 1;
+    }
+}
+
+vector<size_t> MsdRadixSort(vector<string> & R) {
+    vector<const string *> order = Pointers(R);
+    vector<const string *> buffer(R.size());
+    vector<size_t> lcp(R.size(), 0);
+
+    MsdRadixSort(order, buffer, lcp, 0, static_cast<int>(order.size()) - 1, 0);
+    ApplyOrder(R, order);
+    return lcp;
+}
+
+// 平均 LCP：每次比较至少要重复扫描这么多字符
+double AverageLcp(const vector<size_t> & lcp) {
+    if (lcp.empty()) return 0;
+    double sum = 0;
+    for (size_t v : lcp) sum += v;
+    return sum / lcp.size();
+}
+
+bool CheckLcp(const vector<string> & sorted, const vector<size_t> & lcp) {
+    for (size_t i = 1; i < sorted.size(); i++) {
+        if (lcp[i] != LcpFrom(sorted[i - 1], sorted[i], 0)) return false;
+    }
+    return sorted.empty() || lcp[0] == 0;
+}
+
+int main() {
+    printAlgorithmTitle("字符串排序：三路基数快速排序 / MSD 基数排序");
+
+    // 小例子
+    {
+        vector<string> words = {"she", "sells", "seashells", "by", "the", "sea", "shore",
+                                "the", "shells", "she", "sells", "are", "surely", "seashells"};
+        cout << "📊 原始字符串: ";
+        array_utils::print(words, "", 20);
+
+        auto a = words;
+        MultikeyQuickSort(a);
+        cout << "📊 三路基数快速排序: ";
+        array_utils::print(a, "", 20);
+
+        auto b = words;
+        vector<size_t> lcp = MsdRadixSort(b);
+        cout << "📊 MSD 基数排序: ";
+        array_utils::print(b, "", 20);
+        cout << "📊 LCP 数组: ";
+        array_utils::print(lcp, "", 20);
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 正确性：和 std::sort 的结果对比，含空串、重复、互为前缀
+    {
+        cout << "🔍 正确性测试:" << endl;
+        bool valid = true;
+        for (size_t n : {0, 1, 2, 17, 1000, 20000}) {
+            for (size_t prefix : {0, 3, 20}) {
+                auto data = array_utils::generateStrings(n, prefix, 3);
+                for (size_t i = 0; i < n; i += 7) {
+                    data[i].resize(data[i].size() * i % (prefix + 4));
+                }
+                // 含 '\0' 的键："a\0b" 和 "a\0c" 不相等，"a" < "a\0"
+                for (size_t i = 3; i < n; i += 5) {
+                    if (!data[i].empty()) data[i][i % data[i].size()] = '\0';
+                    if (i % 2) data[i].append(i % 11, '\0');
+                }
+
+                auto expected = data;
+                sort(expected.begin(), expected.end());
+
+                auto a = data;
+                MultikeyQuickSort(a);
+                auto b = data;
+                vector<size_t> lcp = MsdRadixSort(b);
+
+                valid = valid && a == expected && b == expected && CheckLcp(b, lcp);
+            }
+        }
+        cout << "   结果: " << (valid ? "✅ 正确" : "❌ 错误") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 不同公共前缀长度下的性能对比
+    {
+        cout << "📈 性能对比（公共前缀越长，比较排序越吃亏）:" << endl;
+        const size_t n = 200000;
+
+        for (size_t prefix : {0, 16, 64, 256}) {
+            auto data = array_utils::generateStrings(n, prefix);
+            cout << "\n   公共前缀 " << prefix << " 字节，" << n << " 个字符串" << endl;
+
+            auto a = data, b = data, c = data, d = data;
+            vector<size_t> lcp;
+
+            AlgorithmTester tester("字符串排序");
+            tester.compareAlgorithms(
+                {"Partition2 快速排序", "std::sort", "三路基数快速排序", "MSD 基数排序 + LCP"},
+                [&]() { QuickSort(a, 0, static_cast<int>(a.size()) - 1); },
+                [&]() { sort(b.begin(), b.end()); },
+                [&]() { MultikeyQuickSort(c); },
+                [&]() { lcp = MsdRadixSort(d); });
+
+            bool valid = a == b && c == b && d == b && CheckLcp(d, lcp);
+            cout << "   平均 LCP: " << fixed << setprecision(1) << AverageLcp(lcp) << endl;
+            cout.unsetf(ios::fixed);
+            cout << "   验证: " << (valid ? "✅" : "❌") << endl;
+        }
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 算法特性:" << endl;
+    cout << "   • 比较排序: O(n log n) 次比较，每次都从头扫过公共前缀" << endl;
+    cout << "   • 三路基数快速排序: 每个字符只在等于段里前进，总扫描量约 O(n log n + D)" << endl;
+    cout << "   • 键前缀缓存: 一次比较 8 个字符，而且不用访问字符串本身" << endl;
+    cout << "   • MSD 基数排序: 每层按一个字节分 256 个桶，顺便输出 LCP 数组" << endl;
+    cout << "   • D = 所有字符串的区分前缀总长度，是读字符的下界" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - 字符串排序
+ *
+ * URL、标识符这种键往往有几十上百字节的公共前缀，
+ * 普通快速排序每比较一次都要把公共前缀从头扫一遍，大部分时间都花在重复劳动上 (╥_╥)
+ *
+ * 🎯 三路基数快速排序（Multikey QuickSort）：
+ * 1. 划分不比较整个字符串，只比较"第 depth 个字符"，分成 <、=、> 三段
+ * 2. < 段和 > 段继续按第 depth 个字符排；= 段这个字符已经确定，depth 前进
+ * 3. 键前缀缓存：把从 depth 开始的 8 个字符拼成一个 uint64 存在元素旁边，
+ *    一次比较 8 个字符，划分时完全不用跳去读字符串 (◕‿◕)
+ * 4. 等于段里 depth 前进 8，统一重新装载缓存；缓存最低字节为 0 说明有串在窗口内结束，
+ *    结束的串是其余串的前缀，按长度挪到等于段最前面（'\0' 也能正确排序）
+ * 5. 整段都落在等于段时，直接算出整段的公共前缀跳过去，不用每 8 个字符装一次
+ *
+ * 🎯 MSD 基数排序：
+ * 1. 按第 depth 个字符计数、分配到 256 个字符桶，每个桶递归处理 depth + 1
+ * 2. 字符串在 depth 处结束的单独一个桶（0 号，共 257 个桶），排在最前面，不和 '\0' 混在一起
+ * 3. 两个相邻桶交界处的 LCP 正好是 depth，分桶时直接写进 LCP 数组 (¬‿¬)
+ * 4. 小桶改用插入排序，LCP 逐个比较算出来
+ * 5. 整段落在同一个桶里（公共前缀很长）时不逐层分配，先一次扫出公共前缀再跳过去
+ *
+ * ⏱️ 时间复杂度：
+ * - 三路基数快速排序：O(n log n + D)，D 是区分前缀总长
+ * - MSD 基数排序：O(D + 桶数 × 递归次数)
+ * 💾 空间复杂度：
+ * - 三路基数快速排序：每个元素多 8 字节缓存，O(n)
+ * - MSD 基数排序：O(n) 的临时指针数组 + O(n) 的 LCP 数组
+ *
+ * 🌟 要点：
+ * - 排序全程只搬指针，最后一次性把字符串按顺序搬过去
+ * - LCP 数组可以直接用于前缀压缩存储、后续的字符串归并 (ﾉ◕ヮ◕)ﾉ
+ */
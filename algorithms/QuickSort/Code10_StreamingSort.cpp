@@ -0,0 +1,531 @@
+#include "utility.h"
+#include "trace.h"
+#include <vector>
+#include <deque>
+#include <cstdint>
+#include <queue>
+#include <climits>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <iostream>
+
+using namespace std;
+using namespace algo;
+
+int Partition2(vector<int> & R, int s, int t) {
+    int i = s, j = s + 1;
+    int base = R[s];
+
+    while (j <= t) {
+        if (R[j] <= base) {
+            i++;
+            swap(R[i], R[j]);
+        }
+        j++;
+    }
+
+    swap(R[s], R[i]);
+    return i;
+}
+
+void QuickSort(vector<int> & R, int s, int t) {
+    if (s < t) {
+        int pivot = Partition2(R, s, t);
+        QuickSort(R, s, pivot - 1);
+        QuickSort(R, pivot + 1, t);
+    }
+}
+
+/**
+ * @brief 败者树：k 个有序段里每次选出最小的队头
+ *
+ * 叶子是各段的队头，内部结点记录那一场比赛的"败者"，tree_[0] 是总冠军。
+ * 取走冠军后只需沿它的叶子到根重赛一遍，每层一次比较，共 log k 次。
+ */
+class LoserTree {
+private:
+    const vector<vector<int>> & runs_;
+    vector<size_t> pos_;
+    // 各段当前队头的值，取完的段记为 INT64_MAX（比任何 int 都大）
+    vector<int64_t> head_;
+    vector<size_t> tree_;
+    size_t k_;
+
+    int64_t headOf(size_t r) const {
+        return pos_[r] < runs_[r].size() ? runs_[r][pos_[r]] : INT64_MAX;
+    }
+
+public:
+    explicit LoserTree(const vector<vector<int>> & runs)
+        : runs_(runs), pos_(runs.size(), 0), head_(runs.size()), tree_(runs.size()), k_(runs.size()) {
+        if (k_ == 0) return;
+        for (size_t r = 0; r < k_; r++) head_[r] = headOf(r);
+
+        // 叶子在 winner[k..2k-1]，自底向上比赛，败者留下，胜者上行
+        vector<size_t> winner(2 * k_);
+        for (size_t r = 0; r < k_; r++) winner[k_ + r] = r;
+        for (size_t i = k_ - 1; i >= 1; i--) {
+            size_t a = winner[2 * i], b = winner[2 * i + 1];
+            if (head_[b] < head_[a]) swap(a, b);
+            winner[i] = a;
+            tree_[i] = b;
+        }
+        tree_[0] = winner[1];
+    }
+
+    /**
+     * @brief 取出当前最小值并重赛
+     */
+    int pop() {
+        size_t w = tree_[0];
+        int value = static_cast<int>(head_[w]);
+        pos_[w]++;
+        head_[w] = headOf(w);
+
+        int64_t key = head_[w];
+        for (size_t node = (k_ + w) / 2; node >= 1; node /= 2) {
+            if (head_[tree_[node]] < key) {
+                swap(tree_[node], w);
+                key = head_[w];
+            }
+        }
+        tree_[0] = w;
+        return value;
+    }
+};
+
+/**
+ * @brief k 路归并：用败者树每次取出所有有序段里最小的队头
+ */
+vector<int> KWayMerge(const vector<vector<int>> & runs) {
+    size_t total = 0;
+    for (const auto & run : runs) total += run.size();
+    TRACE_SCOPE("KWayMerge", static_cast<int64_t>(total));
+
+    vector<int> out(total);
+    LoserTree tree(runs);
+    for (size_t i = 0; i < total; i++) {
+        out[i] = tree.pop();
+    }
+    return out;
+}
+
+/**
+ * @brief 流式排序器：数据一块一块到达，边收边排，最后 k 路归并
+ *
+ * - 每块到达后立即排序（可选交给后台线程，和接收数据重叠）
+ * - 前 k 大和中位数从已排好的段里查，还没排好的块线性扫一遍，查询不等后台排序
+ * - finish() 等所有块排完，归并出最终结果
+ */
+class StreamingSorter {
+private:
+    bool background_;
+
+    // 已排好序的段；后台模式下由工作线程追加
+    vector<vector<int>> runs_;
+    // 后台模式：等待排序的块
+    deque<vector<int>> pending_;
+    // 后台模式：工作线程正在排的块的原件（它排的是副本），供查询读取
+    vector<int> sorting_;
+    mutex mutex_;
+    condition_variable cv_;
+    bool closed_ = false;
+    thread worker_;
+
+    void sortChunk(vector<int> & chunk) {
+        TRACE_SCOPE("SortChunk", static_cast<int64_t>(chunk.size()));
+        QuickSort(chunk, 0, static_cast<int>(chunk.size()) - 1);
+    }
+
+    void workerLoop() {
+        trace::setThreadName("sort worker");
+        while (true) {
+            vector<int> chunk;
+            {
+                unique_lock<mutex> lock(mutex_);
+                cv_.wait(lock, [this]() { return closed_ || !pending_.empty(); });
+                if (pending_.empty()) return;
+                sorting_ = std::move(pending_.front());
+                pending_.pop_front();
+                // 原件留给查询读，排序在副本上做；拷贝 O(m) 比排序 O(m log m) 便宜得多
+                chunk = sorting_;
+            }
+            sortChunk(chunk);
+            lock_guard<mutex> lock(mutex_);
+            runs_.push_back(std::move(chunk));
+            sorting_.clear();
+        }
+    }
+
+    /**
+     * @brief 遍历还没排好的块（排队中的和正在排的原件），调用方持有锁
+     */
+    template<typename Func>
+    void forEachUnsorted(Func func) const {
+        for (const auto & chunk : pending_) func(chunk);
+        if (!sorting_.empty()) func(sorting_);
+    }
+
+    /**
+     * @brief 全部数据（有序段 + 还没排好的块）里第 rank 小的值（rank 从 0 开始），调用方持有锁
+     *
+     * 在值域上二分，每轮数出"不超过 mid 的有几个"，然后把搜索范围收窄：
+     * - 有序段：每段记一个下标窗口，只在窗口里 upper_bound，窗口跟着值域一起缩小
+     * - 还没排好的块：拷出候选值，每轮按 mid 过滤掉一半，总共 O(未排序元素数)
+     * 最多 32 轮，不用排序未排好的块，也不用等后台线程。
+     */
+    int selectAll(size_t rank) const {
+        vector<pair<size_t, size_t>> window(runs_.size());
+        for (size_t r = 0; r < runs_.size(); r++) window[r] = {0, runs_[r].size()};
+        vector<int> candidates;
+        forEachUnsorted([&](const vector<int> & chunk) {
+            candidates.insert(candidates.end(), chunk.begin(), chunk.end());
+        });
+
+        // below：已确定小于 lo 的元素个数
+        size_t below = 0;
+        int64_t lo = INT_MIN, hi = INT_MAX;
+        vector<size_t> cut(runs_.size());
+        while (lo < hi) {
+            int64_t mid = lo + (hi - lo) / 2;
+            size_t in_window = 0;
+            for (size_t r = 0; r < runs_.size(); r++) {
+                const auto & run = runs_[r];
+                cut[r] = upper_bound(run.begin() + window[r].first, run.begin() + window[r].second, mid)
+                         - run.begin();
+                in_window += cut[r] - window[r].first;
+            }
+            size_t candidates_le = count_if(candidates.begin(), candidates.end(),
+                                            [mid](int x) { return x <= mid; });
+
+            bool keep_low = below + in_window + candidates_le > rank;
+            if (keep_low) {
+                hi = mid;
+                for (size_t r = 0; r < runs_.size(); r++) window[r].second = cut[r];
+            } else {
+                lo = mid + 1;
+                below += in_window + candidates_le;
+                for (size_t r = 0; r < runs_.size(); r++) window[r].first = cut[r];
+            }
+            // 无分支压缩：值是随机的，用 if 过滤会频繁分支预测失败
+            size_t kept = 0;
+            for (int x : candidates) {
+                candidates[kept] = x;
+                kept += (x <= mid) == keep_low;
+            }
+            candidates.resize(kept);
+        }
+        return static_cast<int>(lo);
+    }
+
+public:
+    /**
+     * @param background 是否在后台线程排序每一块
+     */
+    explicit StreamingSorter(bool background = true)
+        : background_(background) {
+        if (background_) {
+            worker_ = thread(&StreamingSorter::workerLoop, this);
+        }
+    }
+
+    ~StreamingSorter() {
+        close();
+    }
+
+    StreamingSorter(const StreamingSorter &) = delete;
+    StreamingSorter & operator=(const StreamingSorter &) = delete;
+
+    /**
+     * @brief 收到一块数据
+     */
+    void push(vector<int> chunk) {
+        if (background_) {
+            {
+                lock_guard<mutex> lock(mutex_);
+                pending_.push_back(std::move(chunk));
+            }
+            cv_.notify_one();
+        } else {
+            sortChunk(chunk);
+            runs_.push_back(std::move(chunk));
+        }
+    }
+
+    /**
+     * @brief 到目前为止的前 k 大，从大到小
+     *
+     * 每段的段尾就是该段最大的几个：大根堆里放各段的队尾，弹 k 次，O(k log 段数)。
+     * 还没排好的块只有比这 k 个里最小的还大才可能入选，线性扫一遍挑出来再合并，不等后台排序。
+     */
+    vector<int> topK(size_t k) {
+        lock_guard<mutex> lock(mutex_);
+        // (值, 段号)，各段还没取的部分是 runs_[r][0..rest[r])
+        priority_queue<pair<int, size_t>> heap;
+        vector<size_t> rest(runs_.size());
+        for (size_t r = 0; r < runs_.size(); r++) {
+            rest[r] = runs_[r].size();
+            if (rest[r] > 0) heap.push({runs_[r][--rest[r]], r});
+        }
+
+        vector<int> from_runs;
+        while (from_runs.size() < k && !heap.empty()) {
+            auto [value, r] = heap.top();
+            heap.pop();
+            from_runs.push_back(value);
+            if (rest[r] > 0) heap.push({runs_[r][--rest[r]], r});
+        }
+
+        bool full = from_runs.size() == k;
+        vector<int> extra;
+        forEachUnsorted([&](const vector<int> & chunk) {
+            for (int x : chunk) {
+                if (!full || x > from_runs.back()) extra.push_back(x);
+            }
+        });
+        if (extra.size() > k) {
+            nth_element(extra.begin(), extra.begin() + k, extra.end(), greater<int>());
+            extra.resize(k);
+        }
+        sort(extra.begin(), extra.end(), greater<int>());
+
+        vector<int> result(from_runs.size() + extra.size());
+        merge(from_runs.begin(), from_runs.end(), extra.begin(), extra.end(), result.begin(), greater<int>());
+        result.resize(min(result.size(), k));
+        return result;
+    }
+
+    /**
+     * @brief 到目前为止的中位数（偶数个时取中间两个的平均）
+     *
+     * 在各有序段和还没排好的块上做选择（selectAll），不等后台排序，只拷贝还没排好的块。
+     */
+    double median() {
+        lock_guard<mutex> lock(mutex_);
+        size_t total = 0;
+        for (const auto & run : runs_) total += run.size();
+        forEachUnsorted([&](const vector<int> & chunk) { total += chunk.size(); });
+        if (total == 0) return 0;
+        int low = selectAll((total - 1) / 2);
+        int high = total % 2 ? low : selectAll(total / 2);
+        return (static_cast<double>(low) + high) / 2;
+    }
+
+    /**
+     * @brief 数据流结束：等所有块排完，k 路归并出最终结果
+     */
+    vector<int> finish() {
+        close();
+        vector<int> out = KWayMerge(runs_);
+        runs_.clear();
+        return out;
+    }
+
+private:
+    void close() {
+        if (!worker_.joinable()) return;
+        {
+            lock_guard<mutex> lock(mutex_);
+            closed_ = true;
+        }
+        cv_.notify_one();
+        worker_.join();
+    }
+};
+
+/**
+ * @brief 模拟管道：第 c 块在 start + (c + 1) × delay 时到达
+ *
+ * 按固定时间表到达，处理得慢不会把后面的块往后推，各种方式看到的到达时刻一样。
+ * @param consume 收到一块时调用
+ * @return 最后一块的到达时刻
+ */
+template<typename Consume>
+chrono::steady_clock::time_point Ingest(const vector<vector<int>> & chunks,
+                                        chrono::microseconds delay, Consume consume) {
+    auto start = chrono::steady_clock::now();
+    for (size_t c = 0; c < chunks.size(); c++) {
+        this_thread::sleep_until(start + (c + 1) * delay);
+        consume(chunks[c]);
+    }
+    return start + chunks.size() * delay;
+}
+
+long long MicrosecondsSince(chrono::steady_clock::time_point start) {
+    return chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+}
+
+int main() {
+    printAlgorithmTitle("流式排序：分块排序 + k 路归并");
+
+    trace::setThreadName("ingest");
+    trace::exportAtExit("streaming_trace.json");
+
+    // 小例子：边收边查前 3 大和中位数
+    {
+        vector<vector<int>> chunks = {{5, 3, 9}, {1, 8}, {7, 2, 6, 4}};
+        StreamingSorter sorter(true);
+
+        for (const auto & chunk : chunks) {
+            sorter.push(chunk);
+            cout << "📥 收到一块 (" << chunk.size() << " 个)，前 3 大: ";
+            for (int x : sorter.topK(3)) cout << x << " ";
+            cout << "，中位数: " << sorter.median() << endl;
+        }
+
+        auto result = sorter.finish();
+        cout << "📊 归并结果: ";
+        array_utils::print(result, "", 20);
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 正确性：和整体排序的结果、暴力求的前 k 大 / 中位数对比
+    {
+        cout << "🔍 正确性测试:" << endl;
+        bool valid = true;
+        for (bool background : {false, true}) {
+            for (size_t chunk_count : {1, 3, 50}) {
+                StreamingSorter sorter(background);
+                vector<int> all;
+                for (size_t c = 0; c < chunk_count; c++) {
+                    auto chunk = array_utils::generateRandom(c % 7 * 100, 1, 1000);
+                    all.insert(all.end(), chunk.begin(), chunk.end());
+                    sorter.push(chunk);
+                }
+
+                auto expected = all;
+                sort(expected.begin(), expected.end());
+                vector<int> top(expected.rbegin(), expected.rbegin() + min<size_t>(5, expected.size()));
+                double median = 0;
+                if (!expected.empty()) {
+                    size_t m = expected.size();
+                    median = (static_cast<double>(expected[(m - 1) / 2]) + expected[m / 2]) / 2;
+                }
+
+                valid = valid && sorter.topK(5) == top && sorter.median() == median
+                        && sorter.finish() == expected;
+            }
+        }
+        cout << "   结果: " << (valid ? "✅ 正确" : "❌ 错误") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 延迟对比：最后一块到达后，还要等多久才能拿到完整的有序结果
+    {
+        const size_t chunk_count = 64;
+        const size_t chunk_size = 1 << 15;
+        const chrono::microseconds delay(3000);
+
+        vector<vector<int>> chunks;
+        for (size_t c = 0; c < chunk_count; c++) {
+            chunks.push_back(array_utils::generateRandom(chunk_size, 1, 1000000000));
+        }
+
+        cout << "📈 " << chunk_count << " 块 × " << chunk_size << " 个元素，每 "
+             << delay.count() << " μs 到达一块" << endl;
+        cout << "   " << alignLeft("方式", 24)
+             << alignRight("总耗时(μs)", 14) << alignRight("最后一块之后(μs)", 18) << endl;
+
+        vector<int> batch_result;
+        auto print_row = [](const string & name, long long total, long long latency) {
+            cout << "   " << alignLeft(name, 24)
+                 << setw(14) << total << setw(18) << latency << endl;
+        };
+
+        // 1. 先全部缓存，最后一次性 QuickSort
+        {
+            TRACE_SCOPE("批量排序");
+            auto start = chrono::steady_clock::now();
+            vector<int> buffer;
+            auto last = Ingest(chunks, delay, [&](const vector<int> & chunk) {
+                buffer.insert(buffer.end(), chunk.begin(), chunk.end());
+            });
+            {
+                TRACE_SCOPE("QuickSort", static_cast<int64_t>(buffer.size()));
+                QuickSort(buffer, 0, static_cast<int>(buffer.size()) - 1);
+            }
+            print_row("批量 QuickSort", MicrosecondsSince(start), MicrosecondsSince(last));
+            batch_result = std::move(buffer);
+        }
+
+        // 2. 收到就在当前线程排，最后归并
+        // 3. 收到就交给后台线程排，最后归并
+        // 4. 同 3，每收到一块还查一次前 10 大和中位数（查询不等后台排序）
+        struct Mode {
+            const char * name;
+            bool background;
+            bool query;
+        };
+        for (const Mode & mode : {Mode{"流式 (当前线程排序)", false, false},
+                                  Mode{"流式 (后台线程排序)", true, false},
+                                  Mode{"流式 (后台 + 每块查询)", true, true}}) {
+            TRACE_SCOPE(mode.name);
+            auto start = chrono::steady_clock::now();
+            StreamingSorter sorter(mode.background);
+            long long checksum = 0;
+            auto last = Ingest(chunks, delay, [&](const vector<int> & chunk) {
+                sorter.push(chunk);
+                if (mode.query) {
+                    TRACE_SCOPE("Query");
+                    checksum += sorter.topK(10).front() + static_cast<long long>(sorter.median());
+                }
+            });
+            auto result = sorter.finish();
+
+            print_row(mode.name, MicrosecondsSince(start), MicrosecondsSince(last));
+            if (checksum < 0) {
+                cout << "   ❌ 查询结果异常" << endl;
+            }
+            if (result != batch_result) {
+                cout << "   ❌ 结果和批量排序不一致" << endl;
+            }
+        }
+        cout << "   硬件线程数: " << thread::hardware_concurrency() << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 算法特性:" << endl;
+    cout << "   • 批量排序: 最后一块到达后才开始 O(n log n) 的排序，全部算进延迟" << endl;
+    cout << "   • 流式排序: 每块 O(m log m) 的排序藏在等待数据的间隙里" << endl;
+    cout << "   • 最后只剩一次 k 路归并: O(n log k)，k 是块数" << endl;
+    cout << "   • 前 k 大: 从各段段尾取，再和未排好的块里更大的值合并，接收时不做任何事" << endl;
+    cout << "   • 中位数: 在值域上二分，各有序段的搜索窗口和未排好的候选值每轮一起缩小，查询不等后台排序" << endl;
+    cout << "   • 到达时间按固定时间表，处理慢不会推迟下一块，各方式的延迟可以直接比" << endl;
+    cout << "   • 程序退出时写出 streaming_trace.json，可以看到排序和接收的重叠" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - 流式排序
+ *
+ * 数据从管道一块块过来，如果全部收完才调 QuickSort，
+ * 整个排序时间都叠加在"最后一块到达"之后，用户只能干等 (´-ω-`)
+ *
+ * 🎯 算法思路：
+ * 1. 每收到一块就立即排好，变成一个有序段（run）
+ * 2. 可选交给后台线程排：接收线程只管把块放进队列，
+ *    等下一块数据的时间里工作线程在排序，两者重叠
+ * 3. 数据流结束后，用败者树做 k 路归并：叶子是每段的队头，
+ *    内部结点存每场比赛的败者，取走冠军后沿一条路径重赛，每层只比一次 (◕‿◕)
+ * 4. 查询不等后台线程：已排好的段 + 还没排好的块（队列里的和正在排的原件）一起算，
+ *    接收路径上仍然只有"放进队列"：
+ *    - 前 k 大：各段的段尾放进大根堆弹 k 次，未排好的块里比第 k 个还大的用 nth_element 挑出来合并
+ *    - 中位数：在值域上二分，各段用 upper_bound 计数并缩小下标窗口，
+ *      未排好的值拷成候选，每轮无分支压缩掉一侧
+ *
+ * ⏱️ 时间复杂度：
+ * - 每块排序 O(m log m)，全部块合计 O(n log m)，但和接收重叠
+ * - 最后一块之后：排完最后一块 O(m log m) + 归并 O(n log k)
+ * 💾 空间复杂度：O(n) 的有序段 + O(n) 的归并输出，查询只拷贝还没排好的块
+ *
+ * 🌟 要点：
+ * - 后台线程只有在接收线程"闲着等数据"时才有用武之地，
+ *   单核机器上也能重叠，因为等管道时 CPU 是空的 ┐(´-｀)┌
+ * - 归并比整体排序便宜：log k 远小于 log n (ﾉ◕ヮ◕)ﾉ
+ * - 败者树比 priority_queue 快：每层一次比较，也没有 pop + push 两趟调整
+ */
@@ -0,0 +1,463 @@
+#include "utility.h"
+#include <vector>
+#include <cstdint>
+#include <limits>
+#include <cmath>
+#include <iostream>
+
+using namespace std;
+using namespace algo;
+
+/*
+ * 在升序数组 A 中找 x 的最后一个出现位置（不存在返回 -1），
+ * 和 find_last_occurrence.cpp 的 findLastOccurrence 语义相同。
+ *
+ * 三种做法都先求"最后一个 <= x 的位置"，再看它是不是 x：
+ * 1. 二分查找：log2 n 次探测
+ * 2. 插值查找：按值估计位置，有次数上限，超过就退回二分
+ * 3. 分段线性学习索引：预测位置的误差有保证，只需在小窗口里二分
+ *
+ * 所有查找都带 Policy 模板参数，用 CountingPolicy 可以数出每次查询比较了几次。
+ */
+
+// 插值查找最多探测几次；均匀数据大约 log log n 次就收敛
+const int INTERPOLATION_MAX_PROBES = 8;
+// 学习索引的误差上界：预测位置和真实位置最多差这么多
+const int LEARNED_EPSILON = 16;
+
+/**
+ * @brief 在 A[lo..hi] 里二分，返回第一个 > x 的位置（调用方保证 A[lo-1] <= x < A[hi+1]）
+ */
+template<typename Policy = NoOpPolicy>
+int upperBoundIn(const vector<int>& A, int x, int lo, int hi) {
+    while (lo <= hi) {
+        int mid = lo + (hi - lo) / 2;
+        if (Policy::compare(A[mid] <= x)) {
+            lo = mid + 1;
+        } else {
+            hi = mid - 1;
+        }
+    }
+    return lo;
+}
+
+// 第一个 > x 的位置是 upper，则最后一个 x 在 upper - 1
+inline int lastFromUpper(const vector<int>& A, int x, int upper) {
+    return (upper > 0 && A[upper - 1] == x) ? upper - 1 : -1;
+}
+
+/**
+ * @brief 基准：二分查找最后一个出现位置
+ */
+template<typename Policy = NoOpPolicy>
+int binarySearchLast(const vector<int>& A, int x) {
+    return lastFromUpper(A, x, upperBoundIn<Policy>(A, x, 0, static_cast<int>(A.size()) - 1));
+}
+
+/**
+ * @brief 插值查找最后一个出现位置，探测次数超过 max_probes 就退回二分
+ *
+ * 始终保持 A[0..lo-1] <= x 且 A[hi+1..n-1] > x，插值的两个锚点就用
+ * 已经比较过的 A[lo-1] 和 A[hi+1]。均匀数据上插值的误差约为 √区间长度，
+ * 所以每轮在插值点之外再往目标一侧 √区间长度 处放一个"哨兵"探测，两边一起收紧。
+ * 一轮下来区间没缩到 1/4，说明分布不均匀、插值不灵，立即退回二分，
+ * 单次查询最坏 O(max_probes + log n)。
+ */
+template<typename Policy = NoOpPolicy>
+int interpolationSearchLast(const vector<int>& A, int x, int max_probes = INTERPOLATION_MAX_PROBES) {
+    int n = static_cast<int>(A.size());
+    if (n == 0 || Policy::compare(A[0] > x)) return -1;
+    if (Policy::compare(A[n - 1] <= x)) return lastFromUpper(A, x, n);
+
+    // 此时 A[0] <= x < A[n-1]
+    int lo = 1, hi = n - 2;
+    for (int probe = 0; probe + 2 <= max_probes && lo <= hi; probe += 2) {
+        int before = hi - lo;
+        double left = A[lo - 1], right = A[hi + 1];
+        double offset = (x - left) / (right - left) * (hi - lo + 2);
+        int pos = max(lo, min(hi, lo - 1 + static_cast<int>(offset)));
+        int guard = max(1, static_cast<int>(sqrt(static_cast<double>(before))));
+
+        if (Policy::compare(A[pos] <= x)) {
+            lo = pos + 1;
+            int g = pos + guard;
+            if (g <= hi) {
+                if (Policy::compare(A[g] <= x)) lo = g + 1; else hi = g - 1;
+            }
+        } else {
+            hi = pos - 1;
+            int g = pos - guard;
+            if (g >= lo) {
+                if (Policy::compare(A[g] <= x)) lo = g + 1; else hi = g - 1;
+            }
+        }
+
+        if (hi - lo > before / 4) break;
+    }
+
+    return lastFromUpper(A, x, upperBoundIn<Policy>(A, x, lo, hi));
+}
+
+/**
+ * @brief 分段线性学习索引（PGM 风格）
+ *
+ * 把 f(x) = "第一个 > x 的位置" 用若干条线段近似，每条线段上 |预测 - f(x)| <= epsilon。
+ * 建索引用"收缩锥"贪心：从线段起点出发，每来一个点就把可行斜率区间
+ * 收窄到经过 [y - ε, y + ε] 的范围，区间为空时开新线段，一遍扫描 O(n)。
+ *
+ * 查询：在线段起点数组里二分找线段（线段数远小于 n，常驻缓存），
+ * 算出预测位置，再在 [预测 - ε, 预测 + ε] 里二分。
+ */
+class PiecewiseLinearIndex {
+private:
+    struct Segment {
+        double slope;
+        int64_t y0;  // 线段起点处的 f 值
+    };
+
+    const vector<int>* data_ = nullptr;
+    int epsilon_ = LEARNED_EPSILON;
+    vector<int64_t> first_keys_;  // 每条线段起点的键，单独存放便于二分
+    vector<Segment> segments_;
+
+public:
+    /**
+     * @brief 一遍扫描建索引，O(n)
+     */
+    void build(const vector<int>& A, int epsilon = LEARNED_EPSILON) {
+        data_ = &A;
+        epsilon_ = epsilon;
+        first_keys_.clear();
+        segments_.clear();
+
+        int64_t start_key = 0, start_y = 0;
+        double slope_lo = 0, slope_hi = 0;
+        // 建索引时留 1 的余量，吸收浮点舍入
+        double eps = epsilon - 1;
+
+        auto close_segment = [&]() {
+            // 只有一个点的线段斜率区间是 [0, ∞)，取 0
+            double slope = isinf(slope_hi) ? 0 : (slope_lo + slope_hi) / 2;
+            segments_.push_back({slope, start_y});
+        };
+
+        auto add_point = [&](int64_t key, int64_t y) {
+            if (!first_keys_.empty()) {
+                double dx = static_cast<double>(key - start_key);
+                double lo = max(slope_lo, (y - eps - start_y) / dx);
+                double hi = min(slope_hi, (y + eps - start_y) / dx);
+                if (lo <= hi) {
+                    slope_lo = lo;
+                    slope_hi = hi;
+                    return;
+                }
+                close_segment();
+            }
+
+            // 开新线段；斜率不小于 0，这样线段末尾之后的预测不会往回掉
+            first_keys_.push_back(key);
+            start_key = key;
+            start_y = y;
+            slope_lo = 0;
+            slope_hi = numeric_limits<double>::infinity();
+        };
+
+        // 每个不同的键 a 取点 (a, f(a))；和前一个键 p 之间有空隙时，
+        // 再补一个点 (a-1, f(p))，保证空隙里的 x 也在误差范围内
+        int n = static_cast<int>(A.size());
+        int64_t prev_key = 0, prev_y = 0;
+        for (int i = 0; i < n; i++) {
+            if (i + 1 < n && A[i + 1] == A[i]) continue;  // 只在相同键的最后一个处取点
+
+            int64_t key = A[i];
+            if (prev_y > 0 && key - 1 > prev_key) {
+                add_point(key - 1, prev_y);
+            }
+            add_point(key, i + 1);
+            prev_key = key;
+            prev_y = i + 1;
+        }
+
+        if (!first_keys_.empty()) {
+            close_segment();
+        }
+    }
+
+    /**
+     * @brief 预测 f(x)（调用方保证 x 不小于最小的键），误差不超过 epsilon
+     */
+    template<typename Policy = NoOpPolicy>
+    int64_t predict(int x) const {
+        // 最后一条起点 <= x 的线段
+        int lo = 0, hi = static_cast<int>(first_keys_.size()) - 1;
+        while (lo < hi) {
+            int mid = lo + (hi - lo + 1) / 2;
+            if (Policy::compare(first_keys_[mid] <= x)) {
+                lo = mid;
+            } else {
+                hi = mid - 1;
+            }
+        }
+
+        // 夹在本线段起点和下一条线段起点的 f 值之间，f(x) 一定在这个范围里
+        const Segment& seg = segments_[lo];
+        double predicted = seg.y0 + seg.slope * static_cast<double>(x - first_keys_[lo]);
+        int64_t next_y = lo + 1 < static_cast<int>(segments_.size())
+                         ? segments_[lo + 1].y0 : static_cast<int64_t>(data_->size());
+        int64_t pos = static_cast<int64_t>(predicted + 0.5);
+        return max<int64_t>(seg.y0, min<int64_t>(next_y, pos));
+    }
+
+    /**
+     * @brief 查找 x 的最后一个出现位置：预测 + 窗口内二分
+     */
+    template<typename Policy = NoOpPolicy>
+    int findLast(int x) const {
+        const vector<int>& A = *data_;
+        int n = static_cast<int>(A.size());
+        if (n == 0 || x < first_keys_[0]) return -1;
+
+        int64_t pos = predict<Policy>(x);
+        int from = static_cast<int>(max<int64_t>(0, pos - epsilon_ - 1));
+        int to = static_cast<int>(min<int64_t>(n - 1, pos + epsilon_));
+        return lastFromUpper(A, x, upperBoundIn<Policy>(A, x, from, to));
+    }
+
+    size_t segmentCount() const { return segments_.size(); }
+
+    size_t memoryBytes() const {
+        return first_keys_.size() * sizeof(int64_t) + segments_.size() * sizeof(Segment);
+    }
+};
+
+/**
+ * @brief 近似 Zipf 分布 (s = 1) 的有序键：P(k) ∝ 1/k，小键大量重复，大键稀疏
+ */
+vector<int> generateZipfKeys(size_t n, int max_key) {
+    random_device rd;
+    mt19937 gen(rd());
+    uniform_real_distribution<double> u(0.0, 1.0);
+
+    vector<int> keys(n);
+    double log_max = log(static_cast<double>(max_key));
+    for (size_t i = 0; i < n; i++) {
+        keys[i] = static_cast<int>(exp(u(gen) * log_max));
+    }
+    sort(keys.begin(), keys.end());
+    return keys;
+}
+
+/**
+ * @brief 聚簇的有序键：若干个簇中心均匀分布，簇内正态分布
+ */
+vector<int> generateClusteredKeys(size_t n, int max_key, int clusters = 64, double spread = 2000) {
+    random_device rd;
+    mt19937 gen(rd());
+    uniform_int_distribution<int> center(0, max_key);
+    uniform_int_distribution<int> pick(0, clusters - 1);
+    normal_distribution<double> offset(0.0, spread);
+
+    vector<int> centers(clusters);
+    for (int& c : centers) c = center(gen);
+
+    vector<int> keys(n);
+    for (size_t i = 0; i < n; i++) {
+        double key = centers[pick(gen)] + offset(gen);
+        keys[i] = static_cast<int>(max(0.0, min(static_cast<double>(max_key), key)));
+    }
+    sort(keys.begin(), keys.end());
+    return keys;
+}
+
+vector<int> generateUniformKeys(size_t n, int max_key) {
+    vector<int> keys = array_utils::generateRandom(n, 0, max_key);
+    sort(keys.begin(), keys.end());
+    return keys;
+}
+
+/**
+ * @brief 查询集：一半是数组里有的键，一半是范围内的随机值（大多不存在）
+ */
+vector<int> generateQueries(const vector<int>& A, size_t q) {
+    random_device rd;
+    mt19937 gen(rd());
+    uniform_int_distribution<size_t> index(0, A.size() - 1);
+    uniform_int_distribution<int> value(A.front(), A.back());
+
+    vector<int> queries(q);
+    for (size_t i = 0; i < q; i++) {
+        queries[i] = (i % 2 == 0) ? A[index(gen)] : value(gen);
+    }
+    return queries;
+}
+
+/**
+ * @brief 一行结果：NoOpPolicy 计时，CountingPolicy 数比较次数
+ */
+template<typename Timed, typename Counted>
+void printRow(const string& name, const vector<int>& queries,
+              Timed timed, Counted counted) {
+    long long checksum = 0;
+    auto start = chrono::high_resolution_clock::now();
+    for (int x : queries) checksum += timed(x);
+    auto end = chrono::high_resolution_clock::now();
+    double ns = chrono::duration<double, nano>(end - start).count() / queries.size();
+
+    CountingPolicy::reset();
+    for (int x : queries) checksum -= counted(x);
+    double comparisons = static_cast<double>(CountingPolicy::stats().comparisons) / queries.size();
+
+    cout << "   " << alignLeft(name, 20)
+         << fixed << setprecision(1) << setw(12) << ns << setw(14) << comparisons
+         << (checksum == 0 ? "" : "  ❌ 结果不一致") << endl;
+    cout.unsetf(ios::fixed);
+}
+
+void benchmark(const string& title, const vector<int>& A) {
+    auto queries = generateQueries(A, 1000000);
+
+    PiecewiseLinearIndex index;
+    auto start = chrono::high_resolution_clock::now();
+    index.build(A);
+    auto end = chrono::high_resolution_clock::now();
+    long long build_us = chrono::duration_cast<chrono::microseconds>(end - start).count();
+
+    cout << "\n   " << title << "：" << A.size() << " 个键，学习索引 "
+         << index.segmentCount() << " 条线段 ("
+         << MemoryAnalyzer().formatMemorySize(index.memoryBytes()) << ")，建索引 "
+         << build_us << " μs" << endl;
+
+    cout << "   " << alignLeft("方法", 20)
+         << alignRight("ns/查询", 12) << alignRight("比较次数/查询", 14) << endl;
+
+    printRow("二分查找", queries,
+             [&](int x) { return binarySearchLast(A, x); },
+             [&](int x) { return binarySearchLast<CountingPolicy>(A, x); });
+    printRow("插值查找 (限 8 次)", queries,
+             [&](int x) { return interpolationSearchLast(A, x); },
+             [&](int x) { return interpolationSearchLast<CountingPolicy>(A, x); });
+    printRow("学习索引 (ε = 16)", queries,
+             [&](int x) { return index.findLast(x); },
+             [&](int x) { return index.findLast<CountingPolicy>(x); });
+}
+
+int main() {
+    printAlgorithmTitle("自适应查找：插值查找 / 分段线性学习索引");
+
+    // 测试数据（同 find_last_occurrence.cpp）
+    vector<int> arr = {1, 1, 2, 2, 2, 3, 3, 4, 5, 5, 5, 5};
+
+    cout << "📊 原始数组: ";
+    array_utils::print(arr);
+
+    PiecewiseLinearIndex small_index;
+    small_index.build(arr, 2);
+
+    cout << "\n🔍 查询测试（二分 / 插值 / 学习索引）：" << endl;
+    for (int x : {1, 2, 3, 5, 0, 6}) {
+        int a = binarySearchLast(arr, x);
+        int b = interpolationSearchLast(arr, x);
+        int c = small_index.findLast(x);
+        cout << "   查找 " << x << ": ";
+        if (a != -1) {
+            cout << "位置 " << a << " (值: " << arr[a] << ")";
+        } else {
+            cout << "未找到";
+        }
+        cout << ((a == b && b == c) ? "  ✅" : "  ❌") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 正确性：和 std::upper_bound 对比，顺便检查学习索引的误差上界
+    {
+        cout << "🔍 正确性测试:" << endl;
+        bool valid = true;
+        int64_t max_error = 0;
+        for (size_t n : {1, 2, 17, 1000, 100000}) {
+            vector<vector<int>> inputs = {
+                generateUniformKeys(n, 1000000000),
+                generateUniformKeys(n, 50),
+                generateZipfKeys(n, 1000000000),
+                generateClusteredKeys(n, 1000000000),
+            };
+            for (const auto& A : inputs) {
+                PiecewiseLinearIndex index;
+                index.build(A);
+                vector<int> queries = generateQueries(A, 2000);
+                queries.push_back(A.front() - 1);
+                queries.push_back(A.back() + 1);
+
+                for (int x : queries) {
+                    int upper = static_cast<int>(upper_bound(A.begin(), A.end(), x) - A.begin());
+                    int expected = lastFromUpper(A, x, upper);
+                    valid = valid && binarySearchLast(A, x) == expected
+                            && interpolationSearchLast(A, x) == expected
+                            && index.findLast(x) == expected;
+                    if (x >= A.front()) {
+                        max_error = max(max_error, abs(index.predict(x) - upper));
+                    }
+                }
+            }
+        }
+        cout << "   结果: " << (valid ? "✅ 正确" : "❌ 错误") << endl;
+        cout << "   学习索引实测最大误差: " << max_error << " (上界 ε = " << LEARNED_EPSILON << ")"
+             << (max_error <= LEARNED_EPSILON ? " ✅" : " ❌") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 不同键分布下的对比
+    {
+        cout << "📈 性能对比（100 万次查询，一半命中一半随机）:" << endl;
+        const size_t n = 1000000;
+        benchmark("均匀分布", generateUniformKeys(n, 1000000000));
+        benchmark("Zipf 分布", generateZipfKeys(n, 1000000000));
+        benchmark("聚簇分布", generateClusteredKeys(n, 1000000000));
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 算法特性:" << endl;
+    cout << "   • 二分查找: 稳定 log2 n 次比较，和数据分布无关" << endl;
+    cout << "   • 插值查找: 均匀分布约 log log n 次；分布很偏时退化，所以限次数后退回二分" << endl;
+    cout << "   • 学习索引: O(n) 建索引，查询 = 找线段 + 在 2ε 的窗口里二分" << endl;
+    cout << "   • 学习索引的线段数随分布的\"弯曲程度\"变化，均匀分布最少" << endl;
+    cout << "   • 比较次数少不等于快：二分前几层总是那几个元素，一直在缓存里；" << endl;
+    cout << "     插值每次探测都是随机访问，几乎次次缓存未命中" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - 自适应查找
+ *
+ * 二分查找不管数据长什么样都老老实实比 log2 n 次，
+ * 可很多有序键其实接近均匀分布，"看一眼值就知道大概在哪" (・ω・)
+ *
+ * 🎯 插值查找：
+ * 1. 在 [lo, hi] 里按 x 在 A[lo]..A[hi] 之间的比例估计位置
+ * 2. 每次探测后和二分一样缩小区间，保持"左边都 <= x，右边都 > x"，
+ *    插值的锚点就是区间两侧已经比较过的元素
+ * 3. 插值点只能确定一侧，所以再往目标方向 √区间长度 处放一个哨兵，
+ *    一轮两次探测把区间从 m 缩到约 √m
+ * 4. 最多探测 8 次；一轮下来区间没缩到 1/4 就说明插值不灵，
+ *    立即在剩下的区间里二分，最坏也是 O(log n)
+ *
+ * 🎯 分段线性学习索引（PGM 风格）：
+ * 1. 要学的函数是 f(x) = 第一个 > x 的位置，答案就是 f(x) - 1
+ * 2. 收缩锥：每条线段维护一个可行斜率区间，新点要求直线穿过 [y - ε, y + ε]，
+ *    区间收窄到空就开新线段，一遍扫描 O(n) (◕‿◕)
+ * 3. 键之间有空隙时补一个点 (a-1, f(前一个键))，空隙里的查询也有误差保证
+ * 4. 查询先二分找线段（线段数组很小，常驻缓存），再在 [预测 ± ε] 里二分
+ *
+ * ⏱️ 时间复杂度：
+ * - 二分：O(log n)
+ * - 插值：均匀分布期望 O(log log n)，最坏 O(8 + log n)
+ * - 学习索引：O(log 线段数 + log ε)
+ * 💾 空间复杂度：学习索引每条线段 24 字节，远小于数据本身
+ *
+ * 🌟 要点：
+ * - Zipf 分布小键大量重复，插值查找的估计很不准，次数上限就派上用场了 ┐(´-｀)┌
+ * - ε 越小线段越多：查找窗口变小，但找线段变慢，要折中 (ﾉ◕ヮ◕)ﾉ
+ */
@@ -0,0 +1,433 @@
+#include "utility.h"
+#include <vector>
+#include <cstdint>
+#include <iostream>
+
+#if defined(__AVX2__) || defined(__SSE2__)
+#include <immintrin.h>
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <xmmintrin.h>
+#endif
+
+using namespace std;
+using namespace algo;
+
+/*
+ * 有序数组上的批量查询：count(x)、equal_range(x)、count_in_range(lo, hi)、sum_in_range(lo, hi)
+ *
+ * 和 find_last_occurrence.cpp 面对的是同一个有序数组 A，区别在于查询量很大：
+ * 1. 一次下降同时求两个边界：两条路径重合时共用同一次内存访问
+ * 2. 下降到一个缓存行（16 个 int）以内就停，剩下的用 SIMD 一次数完
+ * 3. 前缀和表：区间求和 = 两个边界处前缀和相减
+ * 4. 批量接口：一组查询交错下降，一个查询等内存时别的查询在算，并提前预取下一层
+ */
+
+// 一个缓存行能放的 int 个数
+const int LINE_INTS = 64 / sizeof(int);
+// 批量查询时一起交错下降的查询个数
+const int BATCH_GROUP = 16;
+
+/**
+ * @brief 预取 p 所在的缓存行（GCC/Clang 用内建函数，MSVC 用 _mm_prefetch，其余平台不预取）
+ */
+inline void prefetch(const void* p) {
+#if defined(__GNUC__) || defined(__clang__)
+    __builtin_prefetch(p);
+#elif defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+    _mm_prefetch(static_cast<const char*>(p), _MM_HINT_T0);
+#else
+    (void)p;
+#endif
+}
+
+/**
+ * @brief mask 中 1 的个数
+ */
+inline int countBits(unsigned mask) {
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_popcount(mask);
+#else
+    int count = 0;
+    for (; mask != 0; mask &= mask - 1) count++;
+    return count;
+#endif
+}
+
+/**
+ * @brief 数 p[0..15] 中有多少个 < x（Inclusive 时数 <= x）
+ */
+template<bool Inclusive>
+inline int countLine(const int* p, int x) {
+#if defined(__AVX2__)
+    __m256i xv = _mm256_set1_epi32(x);
+    __m256i v0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+    __m256i v1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p + 8));
+    // Inclusive: 数 > x 的个数再用 16 去减；否则直接数 x > v
+    __m256i m0 = Inclusive ? _mm256_cmpgt_epi32(v0, xv) : _mm256_cmpgt_epi32(xv, v0);
+    __m256i m1 = Inclusive ? _mm256_cmpgt_epi32(v1, xv) : _mm256_cmpgt_epi32(xv, v1);
+    int mask = _mm256_movemask_ps(_mm256_castsi256_ps(m0))
+             | (_mm256_movemask_ps(_mm256_castsi256_ps(m1)) << 8);
+    int count = countBits(static_cast<unsigned>(mask));
+    return Inclusive ? LINE_INTS - count : count;
+#elif defined(__SSE2__)
+    __m128i xv = _mm_set1_epi32(x);
+    int mask = 0;
+    for (int k = 0; k < 4; k++) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 4 * k));
+        __m128i m = Inclusive ? _mm_cmpgt_epi32(v, xv) : _mm_cmplt_epi32(v, xv);
+        mask |= _mm_movemask_ps(_mm_castsi128_ps(m)) << (4 * k);
+    }
+    int count = countBits(static_cast<unsigned>(mask));
+    return Inclusive ? LINE_INTS - count : count;
+#else
+    int count = 0;
+    for (int i = 0; i < LINE_INTS; i++) {
+        count += Inclusive ? (p[i] <= x) : (p[i] < x);
+    }
+    return count;
+#endif
+}
+
+/**
+ * @brief 已知边界在 [base, base + LINE_INTS] 里，用一个缓存行窗口数出确切位置
+ *
+ * 窗口固定 16 个元素，靠近数组末尾时整体左移，所以不需要处理尾巴。
+ */
+template<bool Inclusive>
+inline int finishLine(const int* a, int n, int base, int x) {
+    int start = min(base, n - LINE_INTS);
+    return start + countLine<Inclusive>(a + start, x);
+}
+
+// 数组比一个缓存行还短时直接数
+template<bool Inclusive>
+inline int countSmall(const int* a, int n, int x) {
+    int count = 0;
+    for (int i = 0; i < n; i++) {
+        count += Inclusive ? (a[i] <= x) : (a[i] < x);
+    }
+    return count;
+}
+
+/**
+ * @brief 有序数组查询器：持有数组引用和前缀和表
+ */
+class SortedArrayQuery {
+private:
+    const vector<int>& A_;
+    vector<int64_t> prefix_;  // prefix_[i] = A[0] + ... + A[i-1]
+
+public:
+    /**
+     * @brief O(n) 建前缀和表
+     */
+    explicit SortedArrayQuery(const vector<int>& A) : A_(A), prefix_(A.size() + 1, 0) {
+        for (size_t i = 0; i < A.size(); i++) {
+            prefix_[i + 1] = prefix_[i] + A[i];
+        }
+    }
+
+    /**
+     * @brief 一次下降同时求 {第一个 >= lo_key 的位置, 第一个 > hi_key 的位置}
+     *
+     * 无分支二分：每层两个基址各自决定走不走右半边，长度序列对所有查询都一样。
+     * lo_key == hi_key 时两条路径在分叉之前访问的是同一个元素，只有一次缓存未命中。
+     */
+    pair<int, int> bounds(int lo_key, int hi_key) const {
+        const int* a = A_.data();
+        int n = static_cast<int>(A_.size());
+        if (n < LINE_INTS) {
+            return {countSmall<false>(a, n, lo_key), countSmall<true>(a, n, hi_key)};
+        }
+
+        int lo = 0, hi = 0, len = n;
+        while (len > LINE_INTS) {
+            int half = len / 2;
+            // 条件传送没有分支预测，下一次访问要等这一次的数据回来；
+            // 所以先把下一层两个可能的位置都预取上
+            int next_half = (len - half) / 2;
+            prefetch(a + lo + next_half);
+            prefetch(a + lo + half + next_half);
+            if (hi != lo) {
+                prefetch(a + hi + next_half);
+                prefetch(a + hi + half + next_half);
+            }
+            lo = (a[lo + half] < lo_key) ? lo + half : lo;
+            hi = (a[hi + half] <= hi_key) ? hi + half : hi;
+            len -= half;
+        }
+        return {finishLine<false>(a, n, lo, lo_key), finishLine<true>(a, n, hi, hi_key)};
+    }
+
+    pair<int, int> equalRange(int x) const {
+        return bounds(x, x);
+    }
+
+    int count(int x) const {
+        auto [first, last] = equalRange(x);
+        return last - first;
+    }
+
+    /**
+     * @brief 最后一个出现位置，语义同 findLastOccurrence
+     */
+    int findLast(int x) const {
+        auto [first, last] = equalRange(x);
+        return first < last ? last - 1 : -1;
+    }
+
+    /**
+     * @brief 值落在 [lo, hi] 里的元素个数
+     */
+    int countInRange(int lo, int hi) const {
+        if (lo > hi) return 0;
+        auto [first, last] = bounds(lo, hi);
+        return last - first;
+    }
+
+    /**
+     * @brief 值落在 [lo, hi] 里的元素之和，两个边界处的前缀和相减
+     */
+    int64_t sumInRange(int lo, int hi) const {
+        if (lo > hi) return 0;
+        auto [first, last] = bounds(lo, hi);
+        return prefix_[last] - prefix_[first];
+    }
+
+    /**
+     * @brief 批量求边界：每组 BATCH_GROUP 个查询交错下降
+     *
+     * 同一层里各查询的访问互不依赖，CPU 可以同时挂着多个缓存未命中；
+     * 算完这一层顺手预取下一层要访问的元素，轮到它时数据多半已经到了。
+     * @param emit emit(i, first, last) 收到第 i 个查询的结果
+     */
+    template<typename Emit>
+    void boundsBatch(const vector<int>& lo_keys, const vector<int>& hi_keys, Emit emit) const {
+        const int* a = A_.data();
+        int n = static_cast<int>(A_.size());
+        size_t q = lo_keys.size();
+
+        for (size_t g = 0; g < q; g += BATCH_GROUP) {
+            int m = static_cast<int>(min<size_t>(BATCH_GROUP, q - g));
+            const int* lk = lo_keys.data() + g;
+            const int* hk = hi_keys.data() + g;
+
+            if (n < LINE_INTS) {
+                for (int j = 0; j < m; j++) {
+                    emit(g + j, countSmall<false>(a, n, lk[j]), countSmall<true>(a, n, hk[j]));
+                }
+                continue;
+            }
+
+            int lo[BATCH_GROUP] = {0}, hi[BATCH_GROUP] = {0};
+            int len = n;
+            while (len > LINE_INTS) {
+                int half = len / 2;
+                int next_half = (len - half) / 2;
+                for (int j = 0; j < m; j++) {
+                    lo[j] = (a[lo[j] + half] < lk[j]) ? lo[j] + half : lo[j];
+                    hi[j] = (a[hi[j] + half] <= hk[j]) ? hi[j] + half : hi[j];
+                    prefetch(a + lo[j] + next_half);
+                    prefetch(a + hi[j] + next_half);
+                }
+                len -= half;
+            }
+
+            for (int j = 0; j < m; j++) {
+                emit(g + j, finishLine<false>(a, n, lo[j], lk[j]), finishLine<true>(a, n, hi[j], hk[j]));
+            }
+        }
+    }
+
+    void equalRangeBatch(const vector<int>& xs, vector<pair<int, int>>& out) const {
+        out.resize(xs.size());
+        boundsBatch(xs, xs, [&](size_t i, int first, int last) { out[i] = {first, last}; });
+    }
+
+    void countBatch(const vector<int>& xs, vector<int>& out) const {
+        out.resize(xs.size());
+        boundsBatch(xs, xs, [&](size_t i, int first, int last) { out[i] = last - first; });
+    }
+
+    void countInRangeBatch(const vector<int>& los, const vector<int>& his, vector<int>& out) const {
+        out.resize(los.size());
+        boundsBatch(los, his, [&](size_t i, int first, int last) {
+            out[i] = los[i] > his[i] ? 0 : last - first;
+        });
+    }
+
+    void sumInRangeBatch(const vector<int>& los, const vector<int>& his, vector<int64_t>& out) const {
+        out.resize(los.size());
+        boundsBatch(los, his, [&](size_t i, int first, int last) {
+            out[i] = los[i] > his[i] ? 0 : prefix_[last] - prefix_[first];
+        });
+    }
+};
+
+const char* simdName() {
+#if defined(__AVX2__)
+    return "AVX2";
+#elif defined(__SSE2__)
+    return "SSE2";
+#else
+    return "标量";
+#endif
+}
+
+int main() {
+    printAlgorithmTitle("有序数组批量查询：count / equal_range / 区间统计");
+
+    // 测试数据（同 find_last_occurrence.cpp）
+    vector<int> arr = {1, 1, 2, 2, 2, 3, 3, 4, 5, 5, 5, 5};
+
+    cout << "📊 原始数组: ";
+    array_utils::print(arr);
+
+    {
+        SortedArrayQuery query(arr);
+        cout << "\n🔍 查询测试：" << endl;
+        for (int x : {1, 2, 3, 5, 0, 6}) {
+            auto [first, last] = query.equalRange(x);
+            cout << "   查找 " << x << ": equal_range = [" << first << ", " << last
+                 << "), count = " << query.count(x) << ", 最后位置 = " << query.findLast(x) << endl;
+        }
+        cout << "   值在 [2, 4] 的元素: " << query.countInRange(2, 4)
+             << " 个，和为 " << query.sumInRange(2, 4) << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 正确性：和 std::equal_range / 暴力求和对比，单个和批量接口都测
+    {
+        cout << "🔍 正确性测试:" << endl;
+        bool valid = true;
+        for (size_t n : {0, 1, 15, 16, 17, 100, 5000}) {
+            for (int max_val : {10, 1000000}) {
+                auto A = array_utils::generateRandom(n, -max_val, max_val);
+                sort(A.begin(), A.end());
+                SortedArrayQuery query(A);
+
+                auto xs = array_utils::generateRandom(500, -max_val - 2, max_val + 2);
+                auto ys = array_utils::generateRandom(500, -max_val - 2, max_val + 2);
+                vector<pair<int, int>> ranges;
+                vector<int> counts, range_counts;
+                vector<int64_t> range_sums;
+                query.equalRangeBatch(xs, ranges);
+                query.countBatch(xs, counts);
+                query.countInRangeBatch(xs, ys, range_counts);
+                query.sumInRangeBatch(xs, ys, range_sums);
+
+                for (size_t i = 0; i < xs.size(); i++) {
+                    auto expected = equal_range(A.begin(), A.end(), xs[i]);
+                    pair<int, int> range = {static_cast<int>(expected.first - A.begin()),
+                                            static_cast<int>(expected.second - A.begin())};
+                    int expected_count = 0;
+                    int64_t expected_sum = 0;
+                    for (int v : A) {
+                        if (xs[i] <= v && v <= ys[i]) {
+                            expected_count++;
+                            expected_sum += v;
+                        }
+                    }
+
+                    valid = valid && query.equalRange(xs[i]) == range && ranges[i] == range
+                            && counts[i] == range.second - range.first
+                            && query.countInRange(xs[i], ys[i]) == expected_count
+                            && range_counts[i] == expected_count
+                            && query.sumInRange(xs[i], ys[i]) == expected_sum
+                            && range_sums[i] == expected_sum;
+                }
+            }
+        }
+        cout << "   结果: " << (valid ? "✅ 正确" : "❌ 错误") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    // 性能：数组远大于缓存，查询量很大
+    {
+        const size_t n = size_t(1) << 23;
+        const size_t q = 1000000;
+        cout << "📈 性能对比（" << n << " 个元素 = "
+             << MemoryAnalyzer().formatMemorySize(n * sizeof(int)) << "，" << q
+             << " 次查询，SIMD: " << simdName() << "）:" << endl;
+
+        auto A = array_utils::generateRandom(n, 0, 100000000);
+        sort(A.begin(), A.end());
+        SortedArrayQuery query(A);
+        auto xs = array_utils::generateRandom(q, 0, 100000000);
+        auto ys = xs;
+        for (int& y : ys) y += 1000;
+
+        vector<int> c1(q), c2(q), c3;
+        AlgorithmTester tester("count(x)");
+        tester.compareAlgorithms(
+            {"两次独立二分 (std::lower/upper_bound)", "一次下降 + SIMD", "批量交错下降 + 预取"},
+            [&]() {
+                for (size_t i = 0; i < q; i++) {
+                    c1[i] = static_cast<int>(upper_bound(A.begin(), A.end(), xs[i])
+                                             - lower_bound(A.begin(), A.end(), xs[i]));
+                }
+            },
+            [&]() {
+                for (size_t i = 0; i < q; i++) c2[i] = query.count(xs[i]);
+            },
+            [&]() { query.countBatch(xs, c3); });
+        cout << "   验证: " << (c1 == c2 && c2 == c3 ? "✅" : "❌") << endl;
+
+        vector<int64_t> s1(q), s2(q), s3;
+        AlgorithmTester range_tester("sum_in_range(x, x + 1000)");
+        range_tester.compareAlgorithms(
+            {"两次独立二分 + 逐个累加", "一次下降 + 前缀和", "批量交错下降 + 前缀和"},
+            [&]() {
+                for (size_t i = 0; i < q; i++) {
+                    auto first = lower_bound(A.begin(), A.end(), xs[i]);
+                    auto last = upper_bound(A.begin(), A.end(), ys[i]);
+                    int64_t sum = 0;
+                    for (auto it = first; it < last; ++it) sum += *it;
+                    s1[i] = sum;
+                }
+            },
+            [&]() {
+                for (size_t i = 0; i < q; i++) s2[i] = query.sumInRange(xs[i], ys[i]);
+            },
+            [&]() { query.sumInRangeBatch(xs, ys, s3); });
+        cout << "   验证: " << (s1 == s2 && s2 == s3 ? "✅" : "❌") << endl;
+    }
+
+    cout << "\n" << string(50, '=') << endl;
+
+    cout << "📚 算法特性:" << endl;
+    cout << "   • 单次查询: O(log n) 次访问，两个边界共用下降路径直到分叉" << endl;
+    cout << "   • 最后一个缓存行: 16 个 int 一次 SIMD 比较 + popcount，没有分支" << endl;
+    cout << "   • 区间求和: O(n) 建前缀和表，之后每次查询 O(log n)，与区间长度无关" << endl;
+    cout << "   • 批量接口: 16 个查询交错执行，同时挂着多个缓存未命中" << endl;
+    cout << "   • 编译时加 -mavx2 使用 AVX2，否则用 SSE2 / 标量版本" << endl;
+
+    return 0;
+}
+
+/*
+ * 📝 算法总结 - 有序数组批量查询
+ *
+ * count(x) = upper_bound - lower_bound，最直接的写法是两次独立二分，
+ * 可两次二分前面十几层走的是同一条路，内存访问白白翻倍 (╯°□°）╯
+ *
+ * 🎯 算法思路：
+ * 1. 无分支二分：base 和 len 两个变量，每层 base 要么不动要么加 half，
+ *    len 的变化和查询无关，所以两个边界可以用同一个循环同时下降
+ * 2. 两个边界在分叉之前访问同一个元素，第二次访问一定命中 L1；
+ *    无分支版本不会预测执行，所以每层把下一层两个候选位置都预取上
+ * 3. len 缩到 16 以内就停：剩下的窗口正好一个缓存行，
+ *    用 SIMD 一次比较 16 个数，movemask + popcount 得到边界的确切位置 (◕‿◕)
+ * 4. 前缀和表 prefix[i] = A[0..i-1] 之和，区间和 = prefix[last] - prefix[first]
+ * 5. 批量：16 个查询一组交错下降，每层算完就预取下一层要看的元素，
+ *    一个查询等内存的时候另外 15 个在干活 (¬‿¬)
+ *
+ * ⏱️ 时间复杂度：单次查询 O(log n)；建前缀和表 O(n)
+ * 💾 空间复杂度：前缀和表 O(n)；批量查询每组 O(1)
+ *
+ * 🌟 要点：
+ * - 窗口固定 16 个元素，靠近末尾时整体左移，SIMD 不用处理尾巴
+ * - 数组越大越超出缓存，批量交错的收益越明显 (ﾉ◕ヮ◕)ﾉ
+ */
@@ -0,0 +1,527 @@
+/**
+ * @file huge_alloc.h
+ * @brief 大页 + NUMA 感知的数组分配 - 给十亿级元素的数组用
+ *
+ * 提供以下核心功能：
+ * - HugePageAllocator：先试 MAP_HUGETLB，失败退回 2MB 对齐 + 透明大页 (madvise)
+ * - 分配时多线程并行"首次触碰"，让页面按策略交错/分块落到各 NUMA 节点
+ * - parallelFor：和 Placement::Partition 用同样的切块和绑核方式，线程访问的正好是本地内存
+ * - 从 /proc/self/smaps 读出实际拿到了多少大页
+ *
+ * 使用示例：
+ * using Alloc = memory::HugePageAllocator<int, memory::Placement::Partition>;
+ * auto data = array_utils::generateRandom(n, 1, 1000, Alloc());
+ * memory::printAllocationReport(data.data(), data.size() * sizeof(int), "数据");
+ *
+ * 非 Linux 平台退化为普通的对齐分配。
+ */
+
+#ifndef HUGE_ALLOC_H
+#define HUGE_ALLOC_H
+
+#include <algorithm>
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <mutex>
+#include <new>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef __linux__
+#include <dirent.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace algo {
+namespace memory {
+
+/// 大页大小（x86-64 的 2MB 页）
+constexpr size_t kHugePageSize = size_t(2) << 20;
+/// 小于这个大小的分配不走大页，直接 operator new
+constexpr size_t kHugeThreshold = kHugePageSize;
+/// 并行首次触碰时每个普通页写一次
+constexpr size_t kSmallPageSize = 4096;
+
+/**
+ * @brief 页面放在哪个 NUMA 节点上
+ */
+enum class Placement {
+    Local,       ///< 不做并行触碰：谁先写归谁（和 std::vector 一样，通常全在主线程的节点）
+    Interleave,  ///< 按页在所有节点间轮流分布（mbind MPOL_INTERLEAVE），适合访问模式不固定的数组
+    Partition,   ///< 切成连续块，第 i 块由绑在第 i 个 CPU 上的线程首次触碰，配合 parallelFor 使用
+};
+
+/**
+ * @brief 实际拿到的是什么页
+ */
+enum class PageSource {
+    Small,            ///< 小分配，operator new
+    HugeTLB,          ///< MAP_HUGETLB，预留的大页池
+    TransparentHuge,  ///< 普通匿名映射 + madvise(MADV_HUGEPAGE)，由内核决定给不给大页
+    Regular,          ///< 以上都不行，普通 4KB 页
+};
+
+inline const char* placementName(Placement placement) {
+    switch (placement) {
+        case Placement::Local: return "本地 (单线程首次触碰)";
+        case Placement::Interleave: return "交错 (按页轮流分到各节点)";
+        case Placement::Partition: return "分块 (每个线程触碰自己那一块)";
+    }
+    return "?";
+}
+
+inline const char* pageSourceName(PageSource source) {
+    switch (source) {
+        case PageSource::Small: return "operator new (小分配)";
+        case PageSource::HugeTLB: return "MAP_HUGETLB";
+        case PageSource::TransparentHuge: return "透明大页 (madvise)";
+        case PageSource::Regular: return "普通 4KB 页";
+    }
+    return "?";
+}
+
+/**
+ * @brief 在线的 NUMA 节点编号（升序），读不到按只有节点 0 算
+ *
+ * 节点编号可能不连续（如 0,2），先读 /sys/devices/system/node/online（"0-1,3" 格式），
+ * 读不到再数 nodeN 目录取其中的 N。
+ */
+inline std::vector<int> numaNodes() {
+    std::vector<int> nodes;
+#ifdef __linux__
+    std::ifstream online("/sys/devices/system/node/online");
+    std::string range;
+    while (std::getline(online, range, ',')) {
+        int first = 0, last = 0;
+        char dash = 0;
+        std::istringstream in(range);
+        if (!(in >> first)) continue;
+        if (!(in >> dash >> last) || dash != '-') last = first;
+        for (int node = first; node <= last; ++node) nodes.push_back(node);
+    }
+    if (nodes.empty()) {
+        if (DIR* dir = opendir("/sys/devices/system/node")) {
+            while (dirent* entry = readdir(dir)) {
+                std::string name = entry->d_name;
+                if (name.size() > 4 && name.compare(0, 4, "node") == 0 &&
+                    std::all_of(name.begin() + 4, name.end(), [](char c) { return c >= '0' && c <= '9'; })) {
+                    nodes.push_back(std::stoi(name.substr(4)));
+                }
+            }
+            closedir(dir);
+        }
+    }
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+#endif
+    if (nodes.empty()) nodes.push_back(0);
+    return nodes;
+}
+
+/**
+ * @brief 系统里的 NUMA 节点数
+ */
+inline int numaNodeCount() {
+    return static_cast<int>(numaNodes().size());
+}
+
+/**
+ * @brief 当前进程允许运行的 CPU 列表
+ */
+inline std::vector<int> allowedCpus() {
+    std::vector<int> cpus;
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (sched_getaffinity(0, sizeof(set), &set) == 0) {
+        for (int cpu = 0; cpu < CPU_SETSIZE; ++cpu) {
+            if (CPU_ISSET(cpu, &set)) cpus.push_back(cpu);
+        }
+    }
+#endif
+    if (cpus.empty()) {
+        for (unsigned i = 0; i < std::max(1u, std::thread::hardware_concurrency()); ++i) {
+            cpus.push_back(static_cast<int>(i));
+        }
+    }
+    return cpus;
+}
+
+/**
+ * @brief 把当前线程绑到一个 CPU 上（失败就算了，只影响放置效果）
+ */
+inline void pinToCpu(int cpu) {
+#ifdef __linux__
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+    sched_setaffinity(0, sizeof(set), &set);
+#else
+    (void)cpu;
+#endif
+}
+
+/**
+ * @brief 作用域内把当前线程绑到一个 CPU 上，离开时恢复原来的 CPU 集合
+ */
+class ScopedPin {
+private:
+#ifdef __linux__
+    cpu_set_t saved_;
+    bool restore_;
+#endif
+
+public:
+    explicit ScopedPin(int cpu) {
+#ifdef __linux__
+        restore_ = sched_getaffinity(0, sizeof(saved_), &saved_) == 0;
+#endif
+        pinToCpu(cpu);
+    }
+
+    ~ScopedPin() {
+#ifdef __linux__
+        if (restore_) sched_setaffinity(0, sizeof(saved_), &saved_);
+#endif
+    }
+
+    ScopedPin(const ScopedPin&) = delete;
+    ScopedPin& operator=(const ScopedPin&) = delete;
+};
+
+/**
+ * @brief 静态切块的并行循环：第 t 个线程处理 [n*t/T, n*(t+1)/T)，并绑在第 t 个可用 CPU 上
+ *
+ * 和 Placement::Partition 的首次触碰用同一套切块和绑核（T 相同的前提是 threads 用默认值），
+ * 所以第 t 个线程访问的那一块内存就在它自己的节点上。
+ * @param func func(begin, end, t)
+ */
+template<typename Func>
+void parallelFor(size_t n, Func func, unsigned threads = 0) {
+    std::vector<int> cpus = allowedCpus();
+    if (threads == 0) threads = static_cast<unsigned>(cpus.size());
+    threads = static_cast<unsigned>(std::max<size_t>(1, std::min<size_t>(threads, n)));
+
+    std::vector<std::thread> workers;
+    for (unsigned t = 1; t < threads; ++t) {
+        workers.emplace_back([&, t]() {
+            pinToCpu(cpus[t % cpus.size()]);
+            func(n * t / threads, n * (t + 1) / threads, t);
+        });
+    }
+    // 第 0 块由调用线程自己做，做的时候临时绑到第 0 个 CPU，做完恢复
+    {
+        ScopedPin pin(cpus[0]);
+        func(0, n / threads, 0u);
+    }
+    for (auto& worker : workers) worker.join();
+}
+
+/**
+ * @brief 一次大分配的记录，供事后查询
+ */
+struct AllocationInfo {
+    const void* addr;
+    size_t bytes;
+    PageSource source;
+    Placement placement;
+    bool interleaved;  ///< 是否真的设置了跨节点交错（单节点或 mbind 失败时为 false）
+    int mbind_error;   ///< mbind 失败时的 errno，没调用或成功时为 0
+};
+
+/**
+ * @brief 大分配登记表 - 分配/释放时加锁，不在热路径上
+ */
+class AllocationLog {
+private:
+    std::mutex mutex_;
+    std::vector<AllocationInfo> entries_;
+
+    AllocationLog() = default;
+
+public:
+    static AllocationLog& instance() {
+        static AllocationLog log;
+        return log;
+    }
+
+    void add(const AllocationInfo& info) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.push_back(info);
+    }
+
+    void remove(const void* addr) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        entries_.erase(std::remove_if(entries_.begin(), entries_.end(),
+                                      [addr](const AllocationInfo& e) { return e.addr == addr; }),
+                       entries_.end());
+    }
+
+    /**
+     * @brief 查找包含 addr 的分配
+     */
+    bool find(const void* addr, AllocationInfo& out) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        auto p = static_cast<const char*>(addr);
+        for (const auto& e : entries_) {
+            auto begin = static_cast<const char*>(e.addr);
+            if (begin <= p && p < begin + e.bytes) {
+                out = e;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+/**
+ * @brief [addr, addr + bytes) 里实际由大页支撑的字节数（读 /proc/self/smaps）
+ *
+ * 统计与该范围重叠的映射里的 AnonHugePages（透明大页）和 Private/Shared_Hugetlb（MAP_HUGETLB）。
+ * 映射可能比范围大，所以结果只是近似值，但足以回答"到底拿没拿到大页"。
+ */
+inline size_t hugePageBytes(const void* addr, size_t bytes) {
+    size_t total = 0;
+#ifdef __linux__
+    std::ifstream smaps("/proc/self/smaps");
+    auto begin = reinterpret_cast<uintptr_t>(addr);
+    auto end = begin + bytes;
+    bool overlapping = false;
+
+    std::string line;
+    while (std::getline(smaps, line)) {
+        uintptr_t lo = 0, hi = 0;
+        char dash = 0;
+        std::istringstream header(line);
+        if (line.find(':') == std::string::npos || line.find(':') > line.find(' ')) {
+            // 映射首行："起始-结束 权限 ..."
+            if (header >> std::hex >> lo >> dash >> hi && dash == '-') {
+                overlapping = lo < end && begin < hi;
+            }
+            continue;
+        }
+        if (!overlapping) continue;
+
+        std::string key;
+        size_t kb = 0;
+        std::istringstream field(line);
+        field >> key >> kb;
+        if (key == "AnonHugePages:" || key == "Private_Hugetlb:" || key == "Shared_Hugetlb:") {
+            total += kb * 1024;
+        }
+    }
+#else
+    (void)addr;
+    (void)bytes;
+#endif
+    return total;
+}
+
+/**
+ * @brief 透明大页的系统设置（/sys/kernel/mm/transparent_hugepage/enabled）
+ */
+inline std::string transparentHugePageMode() {
+    std::ifstream in("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string mode;
+    std::getline(in, mode);
+    return mode.empty() ? "不可用" : mode;
+}
+
+namespace detail {
+
+inline size_t roundUpToHugePage(size_t bytes) {
+    return (bytes + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+}
+
+inline size_t roundDownToHugePage(size_t bytes) {
+    return bytes / kHugePageSize * kHugePageSize;
+}
+
+#ifdef __linux__
+/**
+ * @brief 把 [addr, addr + len) 设成在给定节点间按页交错（直接调 mbind，不依赖 libnuma）
+ *
+ * 掩码按实际的节点编号置位；内核只读 maxnode - 1 位，所以传最大编号 + 2。
+ * @return 0 表示成功；单节点时不调用，也返回 0；失败返回 errno
+ */
+inline int interleaveAcrossNodes(void* addr, size_t len, const std::vector<int>& nodes) {
+    if (nodes.size() <= 1) return 0;
+    const int kMpolInterleave = 3;
+    int max_node = nodes.back();
+    std::vector<unsigned long> mask(max_node / 64 + 1, 0);
+    for (int node : nodes) {
+        mask[node / 64] |= 1UL << (node % 64);
+    }
+    if (syscall(SYS_mbind, addr, len, kMpolInterleave, mask.data(),
+                static_cast<unsigned long>(max_node + 2), 0) == 0) {
+        return 0;
+    }
+    return errno;
+}
+#endif
+
+/**
+ * @brief 按策略并行首次触碰：每个 4KB 页写一个字节，让内核在触碰线程所在节点分配物理页
+ *
+ * 按元素个数 count 调用 parallelFor，和之后使用这块数组的 parallelFor(count, ...) 切块一致；
+ * 各块的字节边界向下取整到 2MB，透明大页时每个 2MB 页只被一个线程触碰，不会被相邻线程抢走。
+ */
+inline void firstTouch(void* addr, size_t len, size_t count, size_t elem_size, Placement placement) {
+    if (placement == Placement::Local) return;
+    char* bytes = static_cast<char*>(addr);
+    parallelFor(count, [=](size_t begin, size_t end, unsigned) {
+        size_t first = begin == 0 ? 0 : roundDownToHugePage(begin * elem_size);
+        size_t last = end == count ? len : roundDownToHugePage(end * elem_size);
+        for (size_t offset = first; offset < last; offset += kSmallPageSize) {
+            bytes[offset] = 0;
+        }
+    });
+}
+
+/**
+ * @brief 分配 count 个 elem_size 字节的元素：MAP_HUGETLB → 2MB 对齐 + 透明大页 → 普通页，然后按策略放置
+ */
+inline void* allocate(size_t count, size_t elem_size, Placement placement) {
+    size_t bytes = count * elem_size;
+    if (bytes < kHugeThreshold) {
+        return ::operator new(bytes);
+    }
+
+#ifdef __linux__
+    size_t len = roundUpToHugePage(bytes);
+    PageSource source = PageSource::HugeTLB;
+
+    void* addr = mmap(nullptr, len, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+    if (addr == MAP_FAILED) {
+        // 大页池没有预留（nr_hugepages = 0）时会走到这里：多映射 2MB，裁成 2MB 对齐
+        size_t padded = len + kHugePageSize;
+        void* raw = mmap(nullptr, padded, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+        if (raw == MAP_FAILED) throw std::bad_alloc();
+
+        uintptr_t start = reinterpret_cast<uintptr_t>(raw);
+        uintptr_t aligned = (start + kHugePageSize - 1) / kHugePageSize * kHugePageSize;
+        if (aligned > start) munmap(raw, aligned - start);
+        size_t tail = (start + padded) - (aligned + len);
+        if (tail > 0) munmap(reinterpret_cast<void*>(aligned + len), tail);
+
+        addr = reinterpret_cast<void*>(aligned);
+        source = madvise(addr, len, MADV_HUGEPAGE) == 0 ? PageSource::TransparentHuge
+                                                        : PageSource::Regular;
+    }
+
+    bool interleaved = false;
+    int mbind_error = 0;
+    if (placement == Placement::Interleave) {
+        std::vector<int> nodes = numaNodes();
+        mbind_error = interleaveAcrossNodes(addr, len, nodes);
+        interleaved = nodes.size() > 1 && mbind_error == 0;
+    }
+    firstTouch(addr, len, count, elem_size, placement);
+
+    AllocationLog::instance().add({addr, len, source, placement, interleaved, mbind_error});
+    return addr;
+#else
+    (void)placement;
+    return ::operator new(bytes, std::align_val_t(kHugePageSize));
+#endif
+}
+
+inline void deallocate(void* addr, size_t bytes) {
+    if (bytes < kHugeThreshold) {
+        ::operator delete(addr);
+        return;
+    }
+#ifdef __linux__
+    AllocationLog::instance().remove(addr);
+    munmap(addr, roundUpToHugePage(bytes));
+#else
+    ::operator delete(addr, std::align_val_t(kHugePageSize));
+#endif
+}
+
+} // namespace detail
+
+/**
+ * @brief 大页 + NUMA 放置的标准分配器，可直接用于 std::vector
+ *
+ * 放置策略是模板参数，分配器本身无状态，vector 拷贝时新数组用同样的策略。
+ */
+template<typename T, Placement P = Placement::Interleave>
+class HugePageAllocator {
+public:
+    using value_type = T;
+
+    template<typename U>
+    struct rebind {
+        using other = HugePageAllocator<U, P>;
+    };
+
+    HugePageAllocator() noexcept = default;
+
+    template<typename U>
+    HugePageAllocator(const HugePageAllocator<U, P>&) noexcept {}
+
+    T* allocate(size_t n) {
+        return static_cast<T*>(detail::allocate(n, sizeof(T), P));
+    }
+
+    void deallocate(T* p, size_t n) noexcept {
+        detail::deallocate(p, n * sizeof(T));
+    }
+
+    template<typename U>
+    bool operator==(const HugePageAllocator<U, P>&) const noexcept { return true; }
+
+    template<typename U>
+    bool operator!=(const HugePageAllocator<U, P>&) const noexcept { return false; }
+};
+
+/// 大页数组
+template<typename T, Placement P = Placement::Interleave>
+using HugeVector = std::vector<T, HugePageAllocator<T, P>>;
+
+/**
+ * @brief 打印一块内存的分配方式、放置策略和实际大页覆盖率
+ */
+inline void printAllocationReport(const void* addr, size_t bytes, const std::string& name) {
+    size_t huge = hugePageBytes(addr, bytes);
+    double ratio = bytes == 0 ? 0 : 100.0 * static_cast<double>(std::min(huge, bytes)) / bytes;
+
+    std::cout << "🧠 " << name << " (" << bytes / (1024 * 1024) << " MB):" << std::endl;
+    AllocationInfo info{};
+    if (AllocationLog::instance().find(addr, info)) {
+        std::cout << "   分配方式: " << pageSourceName(info.source) << std::endl;
+        std::cout << "   放置策略: " << placementName(info.placement);
+        if (info.placement == Placement::Interleave && !info.interleaved) {
+            if (info.mbind_error != 0) {
+                std::cout << "（mbind 失败: " << std::strerror(info.mbind_error) << "，页面按首次触碰分布）";
+            } else {
+                std::cout << "（只有 1 个节点，未设置 mbind）";
+            }
+        }
+        std::cout << std::endl;
+    } else {
+        std::cout << "   分配方式: 标准分配器" << std::endl;
+    }
+    std::cout << "   大页覆盖: " << huge / (1024 * 1024) << " MB (" << std::fixed
+              << std::setprecision(1) << ratio << "%) " << (huge > 0 ? "✅ 拿到了大页" : "❌ 没有大页")
+              << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+} // namespace memory
+} // namespace algo
+
+#endif // HUGE_ALLOC_H
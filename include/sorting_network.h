@@ -0,0 +1,221 @@
+/**
+ * @file sorting_network.h
+ * @brief 编译期生成的排序网络 - 小数组（2~32 个元素）的无分支排序
+ *
+ * 提供以下核心功能：
+ * - 2~9、16 个元素：已知比较器最少的最优网络（查表）
+ * - 10~15 个元素：从 16 路网络裁掉越界比较器（11~15 只比已知最好结果多 0~1 个）
+ * - 17~32 个元素：constexpr 生成 Batcher 奇偶归并网络，同样裁剪
+ * - 每个比较器都是"取小/取大"，编译后没有依赖数据的分支
+ * - sortSmall() 按长度分派，可直接作为快速排序的叶子
+ */
+
+#ifndef SORTING_NETWORK_H
+#define SORTING_NETWORK_H
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace algo {
+namespace sorting_network {
+
+/// 排序网络覆盖的最大长度
+constexpr std::size_t kMaxSize = 32;
+
+/// 比较器数量上限（Batcher 32 路网络为 191 个）
+constexpr std::size_t kMaxComparators = 256;
+
+/**
+ * @brief 一个比较器：保证执行后 a 位置 <= b 位置
+ */
+struct Comparator {
+    unsigned char a;
+    unsigned char b;
+};
+
+/**
+ * @brief 编译期构造的比较器序列
+ */
+struct Network {
+    std::array<Comparator, kMaxComparators> cmp{};
+    std::size_t size = 0;
+
+    constexpr void add(std::size_t a, std::size_t b) {
+        cmp[size].a = static_cast<unsigned char>(a);
+        cmp[size].b = static_cast<unsigned char>(b);
+        ++size;
+    }
+};
+
+namespace detail {
+
+// 已知最优网络（Knuth TAOCP 5.3.4 / Green 16 路网络），按层书写
+constexpr Comparator kOptimal2[] = {{0,1}};
+constexpr Comparator kOptimal3[] = {{0,2},{0,1},{1,2}};
+constexpr Comparator kOptimal4[] = {{0,2},{1,3},{0,1},{2,3},{1,2}};
+constexpr Comparator kOptimal5[] = {
+    {0,3},{1,4}, {0,2},{1,3}, {0,1},{2,4}, {1,2},{3,4}, {2,3}};
+constexpr Comparator kOptimal6[] = {
+    {0,5},{1,3},{2,4}, {1,2},{3,4}, {0,3},{2,5}, {0,1},{2,3},{4,5}, {1,2},{3,4}};
+constexpr Comparator kOptimal7[] = {
+    {0,6},{2,3},{4,5}, {0,2},{1,4},{3,6}, {0,1},{2,5},{3,4},
+    {1,2},{4,6}, {2,3},{4,5}, {1,2},{3,4},{5,6}};
+constexpr Comparator kOptimal8[] = {
+    {0,2},{1,3},{4,6},{5,7}, {0,4},{1,5},{2,6},{3,7}, {0,1},{2,3},{4,5},{6,7},
+    {2,4},{3,5}, {1,4},{3,6}, {1,2},{3,4},{5,6}};
+constexpr Comparator kOptimal9[] = {
+    {0,3},{1,7},{2,5},{4,8}, {0,7},{2,4},{3,8},{5,6}, {0,2},{1,3},{4,5},{7,8},
+    {1,4},{3,6},{5,7}, {0,1},{2,4},{3,5},{6,8}, {2,3},{4,5},{6,7}, {1,2},{3,4},{5,6}};
+constexpr Comparator kOptimal16[] = {
+    {0,13},{1,12},{2,15},{3,14},{4,8},{5,6},{7,11},{9,10},
+    {0,5},{1,7},{2,9},{3,4},{6,13},{8,14},{10,15},{11,12},
+    {0,1},{2,3},{4,5},{6,8},{7,9},{10,11},{12,13},{14,15},
+    {0,2},{1,3},{4,10},{5,11},{6,7},{8,9},{12,14},{13,15},
+    {1,2},{3,12},{4,6},{5,7},{8,10},{9,11},{13,14},
+    {1,4},{2,6},{5,8},{7,10},{9,13},{11,14},
+    {2,4},{3,6},{9,12},{11,13}, {3,5},{6,8},{7,9},{10,12},
+    {3,4},{5,6},{7,8},{9,10},{11,12}, {6,7},{8,9}};
+
+/**
+ * @brief 从表中取出 n 路网络
+ *
+ * 表的规模可以大于 n：多出来的位置视为 +∞，
+ * 凡是碰到下标 >= n 的比较器都是空操作，直接丢掉。
+ */
+template<std::size_t K>
+constexpr Network fromTable(const Comparator (&table)[K], std::size_t n) {
+    Network net{};
+    for (std::size_t i = 0; i < K; ++i) {
+        if (table[i].b < n) {
+            net.add(table[i].a, table[i].b);
+        }
+    }
+    return net;
+}
+
+/**
+ * @brief Batcher 奇偶归并网络
+ *
+ * 按 >= n 的 2 的幂生成，和 fromTable 一样裁掉越界的比较器。
+ */
+constexpr Network batcher(std::size_t n) {
+    Network net{};
+    std::size_t p2 = 1;
+    while (p2 < n) p2 <<= 1;
+
+    for (std::size_t p = 1; p < p2; p <<= 1) {
+        for (std::size_t k = p; k >= 1; k >>= 1) {
+            for (std::size_t j = k % p; j + k < p2; j += 2 * k) {
+                for (std::size_t i = 0; i < k && i + j + k < p2; ++i) {
+                    std::size_t a = i + j, b = i + j + k;
+                    if (a / (2 * p) == b / (2 * p) && b < n) {
+                        net.add(a, b);
+                    }
+                }
+            }
+        }
+    }
+    return net;
+}
+
+template<std::size_t N>
+constexpr Network makeNetwork() {
+    if constexpr (N == 2)      return fromTable(kOptimal2, N);
+    else if constexpr (N == 3) return fromTable(kOptimal3, N);
+    else if constexpr (N == 4) return fromTable(kOptimal4, N);
+    else if constexpr (N == 5) return fromTable(kOptimal5, N);
+    else if constexpr (N == 6) return fromTable(kOptimal6, N);
+    else if constexpr (N == 7) return fromTable(kOptimal7, N);
+    else if constexpr (N == 8) return fromTable(kOptimal8, N);
+    else if constexpr (N == 9) return fromTable(kOptimal9, N);
+    else if constexpr (N >= 10 && N <= 16) return fromTable(kOptimal16, N);
+    else return batcher(N);
+}
+
+} // namespace detail
+
+/// N 个元素的排序网络（编译期常量）
+template<std::size_t N>
+inline constexpr Network kNetwork = detail::makeNetwork<N>();
+
+static_assert(kNetwork<32>.size <= kMaxComparators, "比较器数量超出上限");
+
+/**
+ * @brief 无分支比较交换：执行后 x <= y
+ *
+ * 用一个布尔量同时选出小值和大值（int 会编译成 cmov），
+ * 相等时保持原顺序，对带负载的记录类型也不会丢数据。
+ */
+template<typename T>
+inline void compareExchange(T& x, T& y) {
+    const bool greater = y < x;
+    T lo = greater ? y : x;
+    T hi = greater ? x : y;
+    x = std::move(lo);
+    y = std::move(hi);
+}
+
+namespace detail {
+
+// 下标作为模板实参传入，保证展开后的每个比较器都是常量寻址
+template<std::size_t A, std::size_t B, typename T>
+inline void compareExchangeAt(T* a) {
+    compareExchange(a[A], a[B]);
+}
+
+template<std::size_t N, typename T, std::size_t... I>
+inline void applyNetwork([[maybe_unused]] T* a, std::index_sequence<I...>) {
+    (compareExchangeAt<kNetwork<N>.cmp[I].a, kNetwork<N>.cmp[I].b>(a), ...);
+}
+
+} // namespace detail
+
+/**
+ * @brief 用 N 路排序网络排序 a[0..N-1]（完全展开）
+ */
+template<std::size_t N, typename T>
+inline void sortFixed(T* a) {
+    detail::applyNetwork<N>(a, std::make_index_sequence<kNetwork<N>.size>{});
+}
+
+namespace detail {
+
+template<typename T, std::size_t... N>
+constexpr std::array<void (*)(T*), sizeof...(N)> makeDispatch(std::index_sequence<N...>) {
+    return {{&sortFixed<N, T>...}};
+}
+
+template<typename T>
+inline constexpr auto kDispatch = makeDispatch<T>(std::make_index_sequence<kMaxSize + 1>{});
+
+template<std::size_t... N>
+constexpr std::array<std::size_t, sizeof...(N)> makeSizes(std::index_sequence<N...>) {
+    return {{kNetwork<N>.size...}};
+}
+
+inline constexpr auto kSizes = makeSizes(std::make_index_sequence<kMaxSize + 1>{});
+
+} // namespace detail
+
+/**
+ * @brief n 路网络的比较器个数（运行期查询用）
+ */
+constexpr std::size_t comparatorCount(std::size_t n) {
+    return detail::kSizes[n];
+}
+
+/**
+ * @brief 按长度分派到对应的排序网络
+ * @param a 数组首地址
+ * @param n 元素个数，要求 n <= kMaxSize
+ */
+template<typename T>
+inline void sortSmall(T* a, std::size_t n) {
+    detail::kDispatch<T>[n](a);
+}
+
+} // namespace sorting_network
+} // namespace algo
+
+#endif // SORTING_NETWORK_H
@@ -0,0 +1,486 @@
+/**
+ * @file trace.h
+ * @brief 低开销事件追踪 - 每线程环形缓冲区 + Chrome Trace 导出
+ *
+ * 提供以下核心功能：
+ * - 每个线程一块无锁环形缓冲区，热路径只有几次写内存和一次 rdtsc
+ * - 作用域追踪宏 TRACE_SCOPE，自动记录开始/结束事件
+ * - 退出时导出 Chrome Trace / Perfetto 可读的 JSON
+ *
+ * 使用示例：
+ * {
+ *     TRACE_SCOPE("Partition");
+ *     // 执行算法代码
+ * } // 析构时记录结束事件，不做任何 I/O
+ *
+ * trace::exportAtExit("quicksort_trace.json");
+ * // 用 chrome://tracing 或 https://ui.perfetto.dev 打开
+ *
+ * 定义 ALGO_TRACE_DISABLED 后所有追踪代码编译为空。
+ */
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#  ifdef _MSC_VER
+#    include <intrin.h>
+#  else
+#    include <x86intrin.h>
+#  endif
+#  define ALGO_TRACE_HAS_RDTSC 1
+#endif
+
+namespace algo {
+namespace trace {
+
+/// 每个线程环形缓冲区的事件数（必须是 2 的幂），写满后覆盖最旧的事件
+constexpr size_t kRingCapacity = size_t(1) << 16;
+
+static_assert((kRingCapacity & (kRingCapacity - 1)) == 0, "kRingCapacity 必须是 2 的幂");
+
+/**
+ * @brief 读取时间戳：x86 上是 TSC 周期数，其他平台是 steady_clock 纳秒
+ */
+inline uint64_t now() {
+#ifdef ALGO_TRACE_HAS_RDTSC
+    return __rdtsc();
+#else
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+/**
+ * @brief 一条追踪事件
+ */
+struct Event {
+    const char* name; ///< 事件名（必须长期有效，动态字符串先 intern）
+    uint64_t ticks;   ///< 时间戳
+    int64_t arg;      ///< 附加参数（如子数组长度），导出到 args.n
+    char phase;       ///< 'B' 开始 / 'E' 结束
+};
+
+/**
+ * @brief 单生产者环形缓冲区
+ *
+ * 只有所属线程写入，head_ 用 release 发布；导出时用 acquire 读取，
+ * 热路径上没有锁也没有原子读改写。线程退出后缓冲区交还给 Registry，给新线程复用。
+ */
+class RingBuffer {
+private:
+    std::unique_ptr<Event[]> events_;
+    std::atomic<uint64_t> head_{0};
+    uint32_t tid_;
+    std::string thread_name_;
+
+public:
+    // 值初始化会把整块缓冲区写一遍，页错误在第一次分配时一次付清，不落到热路径上
+    explicit RingBuffer(uint32_t tid)
+        : events_(new Event[kRingCapacity]()), tid_(tid) {}
+
+    /// 交给新线程复用：清空事件，换成新的线程号（只能在 Registry 加锁时调用）
+    void reset(uint32_t tid) {
+        head_.store(0, std::memory_order_relaxed);
+        tid_ = tid;
+        thread_name_.clear();
+    }
+
+    void push(const char* name, char phase, int64_t arg) {
+        uint64_t ticks = now();
+        uint64_t h = head_.load(std::memory_order_relaxed);
+        Event& e = events_[h & (kRingCapacity - 1)];
+        e.name = name;
+        e.ticks = ticks;
+        e.arg = arg;
+        e.phase = phase;
+        head_.store(h + 1, std::memory_order_release);
+    }
+
+    /**
+     * @brief 按时间顺序拷出缓冲区中仍保留的事件
+     *
+     * 所属线程还在写时，拷贝过程中可能有槽位被新事件覆盖：拷完再读一次 head_，
+     * 把期间被覆盖的开头部分丢掉。所属线程已退出或已 join 时结果是精确的。
+     */
+    std::vector<Event> snapshot() const {
+        uint64_t h = head_.load(std::memory_order_acquire);
+        uint64_t start = (h > kRingCapacity) ? (h - kRingCapacity) : 0;
+        std::vector<Event> events;
+        events.reserve(static_cast<size_t>(h - start));
+        for (uint64_t i = start; i < h; ++i) {
+            events.push_back(events_[i & (kRingCapacity - 1)]);
+        }
+
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t after = head_.load(std::memory_order_relaxed);
+        if (after > start + kRingCapacity) {
+            size_t overwritten = static_cast<size_t>(
+                std::min<uint64_t>(after - kRingCapacity - start, events.size()));
+            events.erase(events.begin(), events.begin() + overwritten);
+        }
+        return events;
+    }
+
+    uint64_t total() const { return head_.load(std::memory_order_acquire); }
+
+    /// 丢弃已记录的事件（只能由所属线程调用）
+    void clear() { head_.store(0, std::memory_order_release); }
+
+    uint32_t tid() const { return tid_; }
+
+    const std::string& threadName() const { return thread_name_; }
+
+    void setThreadName(const std::string& name) { thread_name_ = name; }
+};
+
+/**
+ * @brief 全局注册表 - 持有所有线程的缓冲区，负责时钟换算和导出
+ *
+ * 只有注册/退出线程、intern 字符串和导出时加锁，都不在热路径上。
+ * 线程退出时只把实际记录的事件拷成一份紧凑的快照留下，2MB 的环形缓冲区交给下一个新线程，
+ * 所以"每个任务一个线程"的代码占用的缓冲区数只等于同时存活的线程数。
+ */
+class Registry {
+private:
+    /// 已退出线程的事件快照
+    struct RetiredThread {
+        uint32_t tid;
+        std::string name;
+        std::vector<Event> events;
+        uint64_t dropped;
+    };
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<RingBuffer>> buffers_;
+    std::vector<RingBuffer*> active_;
+    std::vector<RingBuffer*> free_;
+    std::vector<RetiredThread> retired_;
+    uint32_t next_tid_ = 1;
+    std::unordered_set<std::string> names_;
+    std::string export_path_;
+
+    uint64_t base_ticks_;
+    std::chrono::steady_clock::time_point base_time_;
+
+    Registry() : base_ticks_(now()), base_time_(std::chrono::steady_clock::now()) {}
+
+    /**
+     * @brief 每微秒的时间戳刻度数，用启动以来的 TSC 与 steady_clock 对比标定
+     */
+    double ticksPerMicrosecond() const {
+#ifdef ALGO_TRACE_HAS_RDTSC
+        // 运行时间太短时标定不准，额外等待一小段
+        auto elapsed = std::chrono::steady_clock::now() - base_time_;
+        if (elapsed < std::chrono::milliseconds(10)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10) - elapsed);
+        }
+        uint64_t ticks = now();
+        double us = std::chrono::duration<double, std::micro>(
+            std::chrono::steady_clock::now() - base_time_).count();
+        return static_cast<double>(ticks - base_ticks_) / us;
+#else
+        return 1000.0;
+#endif
+    }
+
+    static uint64_t droppedOf(uint64_t total) {
+        return (total > kRingCapacity) ? (total - kRingCapacity) : 0;
+    }
+
+    /**
+     * @brief 写出一个线程的名字和事件
+     * @return 写出的事件数
+     */
+    template<typename Separator>
+    size_t writeThread(std::ostream& os, Separator separator, uint32_t tid, const std::string& name,
+                       const std::vector<Event>& events, double ticks_per_us) const {
+        separator();
+        os << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+           << ",\"args\":{\"name\":\"";
+        if (name.empty()) {
+            os << "thread " << tid;
+        } else {
+            writeEscaped(os, name.c_str());
+        }
+        os << "\"}}";
+
+        // 环形缓冲区覆盖掉开头后，可能残留没有配对开始事件的结束事件，跳过它们
+        size_t count = 0;
+        int depth = 0;
+        for (const Event& e : events) {
+            if (e.phase == 'E') {
+                if (depth == 0) continue;
+                --depth;
+            } else {
+                ++depth;
+            }
+
+            double ts = static_cast<double>(static_cast<int64_t>(e.ticks - base_ticks_)) / ticks_per_us;
+            separator();
+            os << "{\"name\":\"";
+            writeEscaped(os, e.name);
+            os << "\",\"ph\":\"" << e.phase << "\",\"pid\":1,\"tid\":" << tid
+               << ",\"ts\":" << std::fixed << std::setprecision(3) << ts;
+            os.unsetf(std::ios::fixed);
+            if (e.phase == 'B' && e.arg != 0) {
+                os << ",\"args\":{\"n\":" << e.arg << "}";
+            }
+            os << "}";
+            ++count;
+        }
+        return count;
+    }
+
+    static void writeEscaped(std::ostream& os, const char* s) {
+        for (; *s; ++s) {
+            char c = *s;
+            if (c == '"' || c == '\\') {
+                os << '\\' << c;
+            } else if (static_cast<unsigned char>(c) < 0x20) {
+                os << "\\u" << std::hex << std::setw(4) << std::setfill('0')
+                   << static_cast<int>(c) << std::dec << std::setfill(' ');
+            } else {
+                os << c;
+            }
+        }
+    }
+
+public:
+    static Registry& instance() {
+        static Registry registry;
+        return registry;
+    }
+
+    /**
+     * @brief 给新线程一块缓冲区：优先复用已退出线程留下的
+     */
+    RingBuffer* registerThread() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        uint32_t tid = next_tid_++;
+        RingBuffer* buffer;
+        if (!free_.empty()) {
+            buffer = free_.back();
+            free_.pop_back();
+            buffer->reset(tid);
+        } else {
+            buffers_.push_back(std::make_unique<RingBuffer>(tid));
+            buffer = buffers_.back().get();
+        }
+        active_.push_back(buffer);
+        return buffer;
+    }
+
+    /**
+     * @brief 线程退出：拷下它的事件，缓冲区放回空闲列表（由所属线程调用，拷贝时没有并发写入）
+     */
+    void retireThread(RingBuffer* buffer) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        retired_.push_back({buffer->tid(), buffer->threadName(), buffer->snapshot(),
+                            droppedOf(buffer->total())});
+        active_.erase(std::find(active_.begin(), active_.end(), buffer));
+        free_.push_back(buffer);
+    }
+
+    void setThreadName(RingBuffer* buffer, const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        buffer->setThreadName(name);
+    }
+
+    /**
+     * @brief 把动态字符串转成长期有效的 const char*
+     */
+    const char* intern(const std::string& name) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return names_.insert(name).first->c_str();
+    }
+
+    /**
+     * @brief 写出 Chrome Trace JSON（可直接被 chrome://tracing / Perfetto 打开）
+     *
+     * 已退出的线程用退出时的快照；仍在运行的线程现场拷一份快照，拷贝期间被覆盖的事件会被丢掉。
+     * 想要完整、精确的结果，应在所有被追踪的线程 join 之后再调用（exportAtExit 就是如此）。
+     * @return 写出的事件数
+     */
+    size_t writeChromeTrace(std::ostream& os) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        double ticks_per_us = ticksPerMicrosecond();
+        size_t count = 0;
+
+        os << "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+        bool first = true;
+        auto separator = [&]() {
+            if (!first) os << ",";
+            os << "\n";
+            first = false;
+        };
+
+        for (const auto& thread : retired_) {
+            count += writeThread(os, separator, thread.tid, thread.name, thread.events, ticks_per_us);
+        }
+        for (const RingBuffer* buffer : active_) {
+            count += writeThread(os, separator, buffer->tid(), buffer->threadName(),
+                                 buffer->snapshot(), ticks_per_us);
+        }
+
+        os << "\n]}\n";
+        return count;
+    }
+
+    bool writeChromeTrace(const std::string& path) {
+        std::ofstream out(path);
+        if (!out) {
+            std::cerr << "❌ 无法写入 trace 文件: " << path << std::endl;
+            return false;
+        }
+
+        size_t count = writeChromeTrace(out);
+        uint64_t dropped = 0;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            for (const auto& thread : retired_) dropped += thread.dropped;
+            for (const RingBuffer* buffer : active_) dropped += droppedOf(buffer->total());
+        }
+
+        std::cout << "📈 trace 已写入 " << path << " (" << count << " 个事件";
+        if (dropped > 0) {
+            std::cout << "，环形缓冲区覆盖了 " << dropped << " 个旧事件";
+        }
+        std::cout << ")" << std::endl;
+        return true;
+    }
+
+    /**
+     * @brief 程序退出时自动导出（重复调用只更新路径）
+     */
+    void exportAtExit(const std::string& path) {
+        bool first_time;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            first_time = export_path_.empty();
+            export_path_ = path;
+        }
+        if (first_time) {
+            // Registry 已构造完毕，atexit 回调一定先于它的析构执行
+            std::atexit([]() {
+                Registry& registry = Registry::instance();
+                registry.writeChromeTrace(registry.export_path_);
+            });
+        }
+    }
+};
+
+/**
+ * @brief 线程对缓冲区的所有权：首次使用时注册，线程退出时析构，把缓冲区交还给 Registry
+ */
+class ThreadSlot {
+private:
+    RingBuffer* buffer_;
+
+public:
+    ThreadSlot() : buffer_(Registry::instance().registerThread()) {}
+    ~ThreadSlot() { Registry::instance().retireThread(buffer_); }
+
+    ThreadSlot(const ThreadSlot&) = delete;
+    ThreadSlot& operator=(const ThreadSlot&) = delete;
+
+    RingBuffer& buffer() { return *buffer_; }
+};
+
+/**
+ * @brief 当前线程的缓冲区（首次使用时注册）
+ */
+inline RingBuffer& localBuffer() {
+    thread_local ThreadSlot slot;
+    return slot.buffer();
+}
+
+/**
+ * @brief 设置当前线程在 trace 中显示的名字
+ */
+inline void setThreadName(const std::string& name) {
+    RingBuffer& buffer = localBuffer();
+    Registry::instance().setThreadName(&buffer, name);
+}
+
+inline void exportAtExit(const std::string& path) {
+    Registry::instance().exportAtExit(path);
+}
+
+/**
+ * @brief 立即导出；仍在运行的线程只能拿到尽力而为的快照，最好在它们 join 之后调用
+ */
+inline bool writeChromeTrace(const std::string& path) {
+    return Registry::instance().writeChromeTrace(path);
+}
+
+#ifndef ALGO_TRACE_DISABLED
+
+/**
+ * @brief 作用域追踪 - 构造时记录开始事件，析构或 stop() 时记录结束事件
+ *
+ * 只写入本线程的环形缓冲区，不做任何 I/O，嵌套使用时互不干扰。
+ */
+class Span {
+private:
+    const char* name_;
+    bool open_;
+
+public:
+    explicit Span(const char* name, int64_t arg = 0) : name_(name), open_(true) {
+        localBuffer().push(name_, 'B', arg);
+    }
+
+    explicit Span(const std::string& name, int64_t arg = 0)
+        : Span(Registry::instance().intern(name), arg) {}
+
+    Span(const Span&) = delete;
+    Span& operator=(const Span&) = delete;
+
+    ~Span() { stop(); }
+
+    void stop() {
+        if (open_) {
+            localBuffer().push(name_, 'E', 0);
+            open_ = false;
+        }
+    }
+};
+
+#else
+
+class Span {
+public:
+    explicit Span(const char*, int64_t = 0) {}
+    explicit Span(const std::string&, int64_t = 0) {}
+    void stop() {}
+};
+
+#endif // ALGO_TRACE_DISABLED
+
+} // namespace trace
+} // namespace algo
+
+#define ALGO_TRACE_CONCAT_INNER(a, b) a##b
+#define ALGO_TRACE_CONCAT(a, b) ALGO_TRACE_CONCAT_INNER(a, b)
+
+/// 追踪当前作用域：TRACE_SCOPE("名字") 或 TRACE_SCOPE("名字", 参数)
+#define TRACE_SCOPE(...) \
+    algo::trace::Span ALGO_TRACE_CONCAT(trace_span_, __LINE__)(__VA_ARGS__)
+
+#endif // TRACE_H
@@ -6,6 +6,7 @@
  *
  * 提供以下核心功能：
  * - 高精度计时器（微秒级）
+ * - 低开销事件追踪（见 trace.h）
  * - 内存使用分析
  * - 数组/容器操作工具
  * - 随机数据生成
@@ -25,10 +26,13 @@
 #include <algorithm>
 #include <functional>
 #include <cstring>
+#include <cstdint>
 #include <cassert>
 #include <sstream>
 #include <cmath>
 
+#include "trace.h"
+
 // 平台特定的内存监控头文件
 #ifdef __APPLE__
 #include <mach/mach.h>
@@ -96,6 +100,88 @@ public:
     }
 };
 
+/**
+ * @brief 操作计数统计结果
+ */
+struct OpStats {
+    size_t comparisons = 0;     ///< 元素比较次数
+    size_t moves = 0;           ///< 写入数组的元素赋值次数（不含交换）
+    size_t swaps = 0;           ///< 元素交换次数
+    size_t max_depth = 0;       ///< 最大递归深度（最外层调用算 1）
+    size_t max_stack_bytes = 0; ///< 最外层到最深层调用之间的栈跨度
+};
+
+/**
+ * @brief 空插桩策略 - 所有钩子都是空的静态 inline 函数
+ *
+ * 策略作为模板参数传入，不占用函数参数；开启优化后钩子全部消失，
+ * 生成的代码和不插桩的版本完全一样。算法里的用法：
+ *   template<typename Policy = NoOpPolicy>
+ *   ... while (i < j && Policy::compare(R[j] >= base)) ...
+ *   R[i] = R[j]; Policy::move();
+ *   swap(R[i], R[j]); Policy::swap();
+ *   Policy::enter(); ...递归... Policy::leave();
+ */
+struct NoOpPolicy {
+    static constexpr bool enabled = false;
+
+    static bool compare(bool result) { return result; }
+    static void move(size_t = 1) {}
+    static void swap() {}
+    static void enter() {}
+    static void leave() {}
+};
+
+/**
+ * @brief 计数插桩策略 - 统计比较、移动、交换次数和递归深度/栈空间
+ *
+ * 计数保存在 thread_local 静态变量里，每个线程各自统计；
+ * 测量前调用 reset()，结束后用 stats() 读取。
+ */
+class CountingPolicy {
+private:
+    inline static thread_local OpStats stats_;
+    inline static thread_local size_t depth_ = 0;
+    inline static thread_local uintptr_t stack_base_ = 0;
+
+public:
+    static constexpr bool enabled = true;
+
+    static bool compare(bool result) {
+        ++stats_.comparisons;
+        return result;
+    }
+
+    static void move(size_t n = 1) { stats_.moves += n; }
+
+    static void swap() { ++stats_.swaps; }
+
+    /**
+     * @brief 进入一层递归：更新深度，并用局部变量地址估计栈指针
+     */
+    static void enter() {
+        char marker = 0;
+        uintptr_t sp = reinterpret_cast<uintptr_t>(&marker);
+
+        if (++depth_ == 1) {
+            stack_base_ = sp;
+        }
+        stats_.max_depth = std::max(stats_.max_depth, depth_);
+
+        size_t span = (stack_base_ > sp) ? (stack_base_ - sp) : (sp - stack_base_);
+        stats_.max_stack_bytes = std::max(stats_.max_stack_bytes, span);
+    }
+
+    static void leave() { --depth_; }
+
+    static const OpStats& stats() { return stats_; }
+
+    static void reset() {
+        stats_ = OpStats();
+        depth_ = 0;
+    }
+};
+
 /**
  * @brief 内存使用分析器 - 支持跨平台内存监控
  */
@@ -165,37 +251,18 @@ public:
         return oss.str();
     }
 
-    /**
-     * @brief 理论空间复杂度计算
-     */
-    size_t calculateTheoreticalSpace(const std::string& algorithm_type, size_t n) const {
-        if (algorithm_type.find("快速排序") != std::string::npos) {
-            // 快速排序：递归栈深度 O(log n)，每层需要常数空间
-            return static_cast<size_t>(std::log2(n) * sizeof(void*) * 3);
-        } else if (algorithm_type.find("归并排序") != std::string::npos) {
-            // 归并排序：需要O(n)辅助空间
-            return n * sizeof(int);
-        } else if (algorithm_type.find("堆排序") != std::string::npos ||
-                   algorithm_type.find("冒泡排序") != std::string::npos ||
-                   algorithm_type.find("插入排序") != std::string::npos ||
-                   algorithm_type.find("选择排序") != std::string::npos) {
-            // 原地排序：O(1)
-            return sizeof(int) * 3; // 几个临时变量
-        }
-        return 0;
-    }
-
     /**
      * @brief 分析额外内存使用
      * @param data_size 数据大小
      * @param algorithm_type 算法类型
+     * @param stats 插桩统计（可选），提供时输出实测的递归深度和栈空间
      */
-    void analyzeMemoryUsage(size_t data_size, const std::string& algorithm_type) {
+    void analyzeMemoryUsage(size_t data_size, const std::string& algorithm_type,
+                            const OpStats* stats = nullptr) {
         size_t current_memory = getCurrentMemoryUsage();
         size_t additional_memory = (current_memory > initial_memory_)
                                    ? (current_memory - initial_memory_)
                                    : 0;
-        size_t theoretical_space = calculateTheoreticalSpace(algorithm_type, data_size);
 
         std::cout << "\n🧠 内存分析:" << std::endl;
         std::cout << "   数据大小: " << data_size << " 个元素 ("
@@ -208,8 +275,19 @@ public:
             std::cout << "   额外内存: " << formatMemorySize(additional_memory) << std::endl;
         }
 
-        if (theoretical_space > 0) {
-            std::cout << "   理论额外空间: " << formatMemorySize(theoretical_space) << std::endl;
+        if (stats != nullptr) {
+            if (stats->max_depth > 0) {
+                std::cout << "   递归深度(实测): " << stats->max_depth << " 层" << std::endl;
+                std::cout << "   递归栈空间(实测): " << formatMemorySize(stats->max_stack_bytes);
+                if (stats->max_depth > 1) {
+                    std::cout << " (每层约 "
+                              << formatMemorySize(stats->max_stack_bytes / (stats->max_depth - 1))
+                              << ")";
+                }
+                std::cout << std::endl;
+            } else {
+                std::cout << "   递归深度(实测): 0 (无递归)" << std::endl;
+            }
         }
 
         // 理论空间复杂度分析
@@ -256,10 +334,12 @@ void print(const Container& container, const std::string& title = "数组内容"
 
 /**
  * @brief 生成随机数组
+ * @param alloc 分配器，大数组可以传 memory::HugePageAllocator（见 huge_alloc.h）
  */
-template<typename T = int>
-std::vector<T> generateRandom(size_t size, T min_val = 1, T max_val = 100) {
-    std::vector<T> arr(size);
+template<typename T = int, typename Alloc = std::allocator<T>>
+std::vector<T, Alloc> generateRandom(size_t size, T min_val = 1, T max_val = 100,
+                                     const Alloc& alloc = Alloc()) {
+    std::vector<T, Alloc> arr(size, alloc);
     std::random_device rd;
     std::mt19937 gen(rd());
     std::uniform_int_distribution<T> dis(min_val, max_val);
@@ -273,9 +353,10 @@ std::vector<T> generateRandom(size_t size, T min_val = 1, T max_val = 100) {
 /**
  * @brief 生成有序数组
  */
-template<typename T = int>
-std::vector<T> generateSorted(size_t size, T start = 1, T step = 1) {
-    std::vector<T> arr(size);
+template<typename T = int, typename Alloc = std::allocator<T>>
+std::vector<T, Alloc> generateSorted(size_t size, T start = 1, T step = 1,
+                                     const Alloc& alloc = Alloc()) {
+    std::vector<T, Alloc> arr(size, alloc);
     for (size_t i = 0; i < size; ++i) {
         arr[i] = start + i * step;
     }
@@ -285,15 +366,63 @@ std::vector<T> generateSorted(size_t size, T start = 1, T step = 1) {
 /**
  * @brief 生成逆序数组
  */
-template<typename T = int>
-std::vector<T> generateReverse(size_t size, T start = 100) {
-    std::vector<T> arr(size);
+template<typename T = int, typename Alloc = std::allocator<T>>
+std::vector<T, Alloc> generateReverse(size_t size, T start = 100, const Alloc& alloc = Alloc()) {
+    std::vector<T, Alloc> arr(size, alloc);
     for (size_t i = 0; i < size; ++i) {
         arr[i] = start - i;
     }
     return arr;
 }
 
+/**
+ * @brief 生成近乎有序数组（有序数组中随机交换少量元素对）
+ * @param disorder_ratio 被打乱的元素对占数组大小的比例
+ */
+template<typename T = int>
+std::vector<T> generateNearlySorted(size_t size, double disorder_ratio = 0.01, T start = 1) {
+    std::vector<T> arr = generateSorted<T>(size, start);
+    if (size < 2) return arr;
+
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<size_t> pos(0, size - 1);
+
+    size_t swaps = static_cast<size_t>(size * disorder_ratio);
+    for (size_t i = 0; i < swaps; ++i) {
+        std::swap(arr[pos(gen)], arr[pos(gen)]);
+    }
+    return arr;
+}
+
+/**
+ * @brief 生成字符串数组（模拟 URL、标识符这类有长公共前缀的键）
+ * @param shared_prefix_len 所有字符串共有的前缀长度
+ * @param suffix_len 前缀之后随机部分的长度（小写字母）
+ */
+inline std::vector<std::string> generateStrings(size_t size, size_t shared_prefix_len,
+                                                size_t suffix_len = 8) {
+    std::random_device rd;
+    std::mt19937 gen(rd());
+    std::uniform_int_distribution<int> letter('a', 'z');
+
+    std::string prefix = "https://";
+    while (prefix.size() < shared_prefix_len) {
+        prefix += "example.com/path/";
+    }
+    prefix.resize(shared_prefix_len);
+
+    std::vector<std::string> arr(size);
+    for (size_t i = 0; i < size; ++i) {
+        arr[i].reserve(shared_prefix_len + suffix_len);
+        arr[i] = prefix;
+        for (size_t j = 0; j < suffix_len; ++j) {
+            arr[i] += static_cast<char>(letter(gen));
+        }
+    }
+    return arr;
+}
+
 /**
  * @brief 验证数组是否已排序
  */
@@ -312,11 +441,11 @@ bool isSorted(const Container& container, bool ascending = true) {
 }
 
 /**
- * @brief 复制数组
+ * @brief 复制数组（沿用原数组的分配器）
  */
-template<typename T>
-std::vector<T> copy(const std::vector<T>& original) {
-    return std::vector<T>(original);
+template<typename T, typename Alloc>
+std::vector<T, Alloc> copy(const std::vector<T, Alloc>& original) {
+    return std::vector<T, Alloc>(original);
 }
 
 } // namespace array_utils
@@ -352,6 +481,44 @@ public:
         return execution_time;
     }
 
+    /**
+     * @brief 测试算法性能，并输出 CountingPolicy 的插桩统计
+     *
+     * 计时只包含 timed（NoOpPolicy 版本），插桩计数的开销不算进去；
+     * counted 调用 CountingPolicy 版本，例如 QuickSort<CountingPolicy>(...)，单独跑一遍取统计。
+     * 两者应作用在相同的输入上。内存分析中的递归深度和栈空间取自实测值。
+     */
+    template<typename TimedFunc, typename CountedFunc>
+    long long testPerformanceCounted(TimedFunc timed, CountedFunc counted, size_t data_size = 0) {
+        std::cout << "\n🚀 开始测试算法: " << algorithm_name_ << std::endl;
+        std::cout << "=" << std::string(50, '=') << std::endl;
+
+        Timer timer(algorithm_name_);
+        timed();
+        long long execution_time = timer.stop();
+
+        CountingPolicy::reset();
+        counted();
+        printOpStats(CountingPolicy::stats());
+
+        if (data_size > 0) {
+            memory_analyzer_.analyzeMemoryUsage(data_size, algorithm_name_, &CountingPolicy::stats());
+        }
+
+        std::cout << "✅ 算法测试完成" << std::endl;
+        return execution_time;
+    }
+
+    /**
+     * @brief 输出操作计数
+     */
+    static void printOpStats(const OpStats& stats) {
+        std::cout << "\n🔢 操作计数:" << std::endl;
+        std::cout << "   比较次数: " << stats.comparisons << std::endl;
+        std::cout << "   移动次数: " << stats.moves << std::endl;
+        std::cout << "   交换次数: " << stats.swaps << std::endl;
+    }
+
     /**
      * @brief 比较多个算法的性能
      */
@@ -451,7 +618,55 @@ inline void printAlgorithmTitle(const std::string& algorithm_name) {
     std::cout << "=" << std::string(50, '=') << std::endl;
 }
 
-#define TIMER_START(name) Timer timer(name)
+/**
+ * @brief 字符串在终端里占的列数
+ *
+ * 按 UTF-8 解码：中日韩文字、全角符号和 emoji 占 2 列，其余字符占 1 列。
+ * std::setw 按字节数补齐，遇到多字节字符就会错位，表格对齐请用 alignLeft/alignRight。
+ */
+inline size_t displayWidth(const std::string& text) {
+    size_t width = 0;
+    for (size_t i = 0; i < text.size();) {
+        unsigned char lead = static_cast<unsigned char>(text[i]);
+        size_t length = lead < 0x80 ? 1 : lead < 0xE0 ? 2 : lead < 0xF0 ? 3 : 4;
+        uint32_t cp = length == 1 ? lead : lead & (0x7F >> length);
+        for (size_t k = 1; k < length && i + k < text.size(); ++k) {
+            cp = (cp << 6) | (static_cast<unsigned char>(text[i + k]) & 0x3F);
+        }
+        i += length;
+
+        bool wide = (cp >= 0x1100 && cp <= 0x115F) ||   // 谚文字母
+                    (cp >= 0x2E80 && cp <= 0xA4CF) ||   // 中日韩部首、假名、汉字
+                    (cp >= 0xAC00 && cp <= 0xD7A3) ||   // 谚文音节
+                    (cp >= 0xF900 && cp <= 0xFAFF) ||   // 兼容汉字
+                    (cp >= 0xFE30 && cp <= 0xFE4F) ||   // 竖排标点
+                    (cp >= 0xFF00 && cp <= 0xFF60) ||   // 全角符号
+                    (cp >= 0xFFE0 && cp <= 0xFFE6) ||
+                    (cp >= 0x1F300 && cp <= 0x1FAFF);   // emoji
+        width += wide ? 2 : 1;
+    }
+    return width;
+}
+
+/**
+ * @brief 按显示宽度左对齐（右侧补空格）
+ */
+inline std::string alignLeft(const std::string& text, size_t width) {
+    size_t used = displayWidth(text);
+    return used >= width ? text : text + std::string(width - used, ' ');
+}
+
+/**
+ * @brief 按显示宽度右对齐（左侧补空格）
+ */
+inline std::string alignRight(const std::string& text, size_t width) {
+    size_t used = displayWidth(text);
+    return used >= width ? text : std::string(width - used, ' ') + text;
+}
+
+// 计时宏改为追踪区间：只写本线程的环形缓冲区，不再在热路径上输出到 std::cout
+// 需要逐行输出时间的场景请直接使用 Timer
+#define TIMER_START(name) algo::trace::Span timer(name)
 #define TIMER_STOP() timer.stop()
 
 #define PRINT_ARRAY(arr, title) array_utils::print(arr, title)